@@ -2,7 +2,12 @@
 #define _ADCMONITOR_H_
 
 #include <stdint.h>
-#include "stm32h7xx_hal.h"
+
+#ifndef UNIT_TESTING
+    #include "stm32h7xx_hal.h"
+#else
+    #include "fake_stm32xxxx_hal.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -17,10 +22,69 @@ extern "C" {
  * each sample is fetched using pData[SampleNo * noOfChannls + channelNumber] */
 typedef void (*ADCCallBack)(int32_t *pBuffer, int noOfChannels, int noOfSamples);
 
+// Completion of a half buffer, passed to the callback of ADCMonitorLoopEx/ADCMonitorLoopHandleEx.
+// The timestamp is the DWT cycle counter captured in the DMA interrupt and extended to 64 bit.
+typedef struct {
+    uint32_t sequence;  // Number of half buffers completed by the ADC, including this one
+    uint64_t timestamp; // Cycle counter when the half buffer completed
+} ADCBufferInfo_t;
+
+typedef void (*ADCCallBackEx)(int32_t *pBuffer, int noOfChannels, int noOfSamples, const ADCBufferInfo_t *info);
+
+// Statistics of a single channel in a half buffer.
+// Derived values are computed by the caller, e.g. mean = sum/count, rms = sqrt(sumSquares/count).
+typedef struct {
+    int64_t  sum;        // Sum of samples
+    uint64_t sumSquares; // Sum of squared samples
+    uint64_t absSum;     // Sum of absolute samples
+    int32_t  min;        // Smallest sample
+    int32_t  max;        // Largest sample
+    uint32_t count;      // Number of samples included
+} ADCChannelStat_t;
+
+// D-cache support (STM32H7). ADCMonitorLoop invalidates the finished half buffer before and after
+// the callback, so the D-cache can be enabled. Cache maintenance works on whole 32 byte lines, so
+// the DMA buffer must not share a cache line with other data: declare it with ADC_DMA_BUFFER,
+// optionally placed in AXI SRAM (D1) or D2 SRAM. The DMA can not reach DTCM.
+//     ADC_DMA_BUFFER(adcBuffer, 2 * ADC_CHANNELS * ADC_SAMPLES) ADC_DMA_IN_D2_SRAM;
+// Preferably make each half buffer a whole number of cache lines (channels * samples multiple of 8).
+#define ADC_CACHE_LINE 32
+
+// Number of int32_t in length samples rounded up to whole cache lines.
+#define ADC_DMA_CACHE_WORDS(length) \
+    ((((length) * sizeof(int32_t) + ADC_CACHE_LINE - 1) / ADC_CACHE_LINE) * (ADC_CACHE_LINE / sizeof(int32_t)))
+
+// Declares a cache line aligned DMA buffer of at least length samples.
+#define ADC_DMA_BUFFER(name, length) \
+    int32_t name[ADC_DMA_CACHE_WORDS(length)] __attribute__((aligned(ADC_CACHE_LINE)))
+
+// Linker sections of AXI SRAM and D2 SRAM, override to match the linker script of the project.
+#ifndef ADC_DMA_AXI_SRAM_SECTION
+#define ADC_DMA_AXI_SRAM_SECTION ".RAM_D1"
+#endif
+#ifndef ADC_DMA_D2_SRAM_SECTION
+#define ADC_DMA_D2_SRAM_SECTION ".RAM_D2"
+#endif
+#define ADC_DMA_IN_AXI_SRAM __attribute__((section(ADC_DMA_AXI_SRAM_SECTION)))
+#define ADC_DMA_IN_D2_SRAM  __attribute__((section(ADC_DMA_D2_SRAM_SECTION)))
+
+// Max number of ADC peripherals streaming at once (ADC1, ADC2 and ADC3).
+#define ADC_MONITOR_MAX_INSTANCES 3
+
+// Handle of an ADC peripheral streaming through the monitor.
+typedef struct ADCMonitorInstance* ADCMonitorHandle;
+
 // ADC Monitor initialisation function. MUST be called before call to any other function
 // Must only be called once.
 void ADCMonitorInit(ADC_HandleTypeDef* hadc, int32_t *pData, uint32_t Length);
 
+// Handle based initialisation for boards streaming several ADCs concurrently. Each ADC
+// peripheral (hadc->Instance) has its own DMA buffer, channel count and callback. The statistics
+// functions below find the instance from the buffer passed to them.
+// Must only be called once per ADC peripheral.
+// @Return Handle to pass to ADCMonitorLoopHandle
+ADCMonitorHandle ADCMonitorInitHandle(ADC_HandleTypeDef* hadc, int32_t *pData, uint32_t Length);
+
 // Function for calibrating offset and linearity of ADC. Must be done upon startup to ensure
 // precise measurements.
 // Must be run while ADC is not running i.e. before ADCMonitorInit.
@@ -30,6 +94,18 @@ int ADCCalibrationInit(ADC_HandleTypeDef* hadc, uint32_t CalibrationMode, uint32
 // ADCCallBack function. If new buffer, callback is called, else nothing is done.
 void ADCMonitorLoop(ADCCallBack cb);
 
+// As ADCMonitorLoop for the ADC peripheral of the handle.
+void ADCMonitorLoopHandle(ADCMonitorHandle handle, ADCCallBack cb);
+
+// As ADCMonitorLoop/ADCMonitorLoopHandle, the callback also gets the sequence number and timestamp.
+void ADCMonitorLoopEx(ADCCallBackEx cb);
+void ADCMonitorLoopHandleEx(ADCMonitorHandle handle, ADCCallBackEx cb);
+
+// Shortest and longest interval between half buffers in CPU cycles since init or
+// ADCMonitorResetJitter. minPeriodCycles is UINT32_MAX until two half buffers have completed.
+void ADCMonitorGetJitter(ADCMonitorHandle handle, uint32_t *minPeriodCycles, uint32_t *maxPeriodCycles);
+void ADCMonitorResetJitter(ADCMonitorHandle handle);
+
 // perform a Cumulative moving average on data in buffer.
 // Note, data is altereed in buffer.
 // @param preveous calculated cma
@@ -41,8 +117,29 @@ int32_t cmaAvarage(int32_t *pData, uint16_t channel, int32_t cma, int k);
 double ADCMean(const int32_t *pData, uint16_t channel);
 double ADCAbsMean(const int32_t *pData, uint16_t channel);
 double ADCrms(const int32_t *pData, uint16_t channel);
+// The largest sample is found as a signed value. The return type is kept unsigned for existing
+// callers, cast the result to int32_t if samples may be negative, e.g. after ADCSetOffset.
 uint32_t ADCmax(const int32_t *pData, uint16_t channel);
 
+// Single precision versions of the helpers above, using the FPU of Cortex-M4F/M7 (sqrtf)
+// instead of double precision library calls. The 64 bit sums are reduced to 32 bits before the
+// conversion to float, so the results are accurate to float precision.
+float ADCMeanF(const int32_t *pData, uint16_t channel);
+float ADCAbsMeanF(const int32_t *pData, uint16_t channel);
+float ADCrmsF(const int32_t *pData, uint16_t channel);
+
+// Fixed point versions, integer only. Results have ADC_Q_FRAC_BITS fractional bits.
+#define ADC_Q_FRAC_BITS 8
+int32_t ADCMeanQ(const int32_t *pData, uint16_t channel);
+int32_t ADCAbsMeanQ(const int32_t *pData, uint16_t channel);
+int32_t ADCrmsQ(const int32_t *pData, uint16_t channel);
+
+// Statistics of all channels gathered in a single sequential pass over the half buffer.
+// @Param pData Pointer to buffer from callback function
+// @Param stats Array with room for one entry per channel (noOfChannels from ADCMonitorInit)
+// @Return 0 on success, -1 if the buffer is not available or the arguments are invalid
+int ADCFrameStats(const int32_t *pData, ADCChannelStat_t *stats);
+
 // @Description Compute fast mean using bit shift (NOTE: Can only be used if array length is multiple of 2)
 // @Param pData Pointer to buffer from callback function
 // @param channel Channel in sample Data to adjust.
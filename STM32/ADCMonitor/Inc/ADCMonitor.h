@@ -9,6 +9,7 @@
 #define _ADCMONITOR_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifndef UNIT_TESTING
     #include "stm32f4xx_hal.h"
@@ -29,6 +30,80 @@ typedef struct {
     uint32_t end;   // Index where the sinewave ends
 } SineWaveIndexes_t;
 
+#define ADC_ZERO_CROSS_MAX_PERIOD 4096 // Default maxPeriod of ADCZeroCross_t [samples]
+
+/*
+ * State of the streaming zero crossing detector, see ADCZeroCrossInit/ADCZeroCrossUpdate.
+ * A rising crossing is detected when the signal reaches level after it has been below
+ * level - hysteresis, so noise smaller than the hysteresis does not give false crossings.
+ * The crossing itself is interpolated between the two samples around level.
+*/
+typedef struct {
+    int16_t  level;        // Crossing level, e.g. the offset of the signal
+    int16_t  hysteresis;   // Distance below level the signal must reach before the next crossing
+    bool     armed;        // Signal has been below level - hysteresis since the latest crossing
+    bool     locked;       // lastCrossing is valid
+    bool     hasPrevious;  // previous is valid
+    int16_t  previous;     // Last sample of the previous half buffer
+    float    lastCrossing; // Latest crossing in samples relative to the start of the next half buffer (<= 0)
+    float    period;       // Average period of the cycles ending in the latest half buffer [samples], 0 if unknown
+    float    phase;        // Phase at the first sample of the latest half buffer [0;1[ cycles after a rising crossing
+    uint32_t cycles;       // Number of complete periods seen since ADCZeroCrossInit
+    float    maxPeriod;    // Longest period tracked [samples], the signal is lost after this many samples without a crossing
+} ADCZeroCross_t;
+
+/*
+ * State of the whole cycle true RMS accumulator, see ADCCycleRmsInit/ADCCycleRmsUpdate.
+ * Sums are carried between half buffers and a result is produced for every cyclesPerResult
+ * complete cycles, delimited by rising crossings.
+*/
+typedef struct {
+    ADCZeroCross_t zc;          // Cycle detection, zc.locked is set once the first crossing is found
+    uint16_t cyclesPerResult;   // Number of complete cycles in each result
+    uint16_t cycles;            // Complete cycles in the sums below
+    int64_t  sum;               // Sum of samples of the cycles in progress
+    uint64_t sumSquares;        // Sum of squared samples of the cycles in progress
+    uint32_t count;             // Number of samples of the cycles in progress
+    float    rms;               // True RMS of the latest result
+    float    mean;              // Mean of the latest result
+    uint32_t results;           // Number of results since ADCCycleRmsInit
+} ADCCycleRms_t;
+
+/*
+ * Statistics of a single channel in a half buffer, gathered in one pass by ADCChannelStats.
+ * Derived values are computed by the caller, e.g. mean = sum/count, rms = sqrt(sumSquares/count).
+*/
+typedef struct {
+    int64_t  sum;        // Sum of samples
+    uint64_t sumSquares; // Sum of squared samples
+    uint64_t absSum;     // Sum of absolute samples
+    int16_t  min;        // Smallest sample
+    int16_t  max;        // Largest sample
+    uint32_t count;      // Number of samples included
+} ADCChannelStat_t;
+
+/*
+ * Throughput telemetry of ADCMonitorLoop, see ADCMonitorGetTelemetry.
+ * Cycle counts are taken from the DWT cycle counter, which is enabled by ADCMonitorInit.
+*/
+typedef struct {
+    uint32_t sequence;        // Number of half buffers completed by the DMA since ADCMonitorInit
+    uint32_t dropped;         // Half buffers never passed to the callback since ADCMonitorLoop was called too late
+    uint32_t overruns;        // Half buffers overwritten by the DMA while the callback processed them
+    uint32_t periodCycles;    // CPU cycles between the two latest half buffers
+    uint32_t minPeriodCycles; // Shortest periodCycles since ADCMonitorInit/ADCMonitorResetTelemetry, UINT32_MAX if none
+    uint32_t maxPeriodCycles; // Longest periodCycles since ADCMonitorInit/ADCMonitorResetTelemetry
+    uint32_t callbackCycles;  // CPU cycles used by the latest callback
+    uint32_t loadPermille;    // callbackCycles relative to periodCycles [0.1%]
+    uint32_t maxLoadPermille; // Highest loadPermille since ADCMonitorInit/ADCMonitorResetTelemetry
+} ADCMonitorTelemetry_t;
+
+/*
+ * Number of fractional bits of the fixed point statistics (ADCrmsQ, ADCMeanQ, ...), i.e. the
+ * results are in units of 1/256 LSB.
+*/
+#define ADC_Q_FRAC_BITS 8
+
 /*
  * Callback function from ADCMonitorLoop.
  * The format of the buffer is [ CH0{s0}, CH1{s0},,,, CHN{s0},
@@ -40,13 +115,54 @@ typedef struct {
 */
 typedef void (*ADCCallBack)(int16_t *pBuffer, int noOfChannels, int noOfSamples);
 
+/*
+ * Completion of a half buffer, passed to the callback of ADCMonitorLoopEx.
+ * The timestamp is the DWT cycle counter, captured in the DMA interrupt and extended to 64 bit, so
+ * it does not wrap and can be correlated with other cycle counter timestamps.
+*/
+typedef struct {
+    uint32_t sequence;  // Number of half buffers completed since ADCMonitorInit, including this one
+    uint64_t timestamp; // Cycle counter when the half buffer completed
+} ADCBufferInfo_t;
+
+typedef void (*ADCCallBackEx)(int16_t *pBuffer, int noOfChannels, int noOfSamples, const ADCBufferInfo_t *info);
+
+/*
+ * Number of samples per channel transposed at a time by ADCDeinterleave. Reads stay within a
+ * block of ADC_DEINTERLEAVE_BLOCK * noOfChannels samples while every channel is written
+ * sequentially.
+*/
+#define ADC_DEINTERLEAVE_BLOCK 32
+
+// Largest number of channels of a sample when decimating, the regular conversion ranks of the ADC
+#define ADC_MAX_CHANNELS 16
+
+/*
+ * DMA buffer length for ADCMonitorInit when decimating by factor (ADCMonitorSetDecimation), given
+ * the ADC sample rate of each channel and the wanted callback rate in Hz. The samples of a half
+ * buffer are rounded up to a multiple of factor as ADCMonitorSetDecimation requires, so the actual
+ * callback rate may be slightly lower than callbackRate.
+*/
+#define ADC_DECIMATION_DMA_LENGTH(noOfChannels, sampleRate, factor, callbackRate) \
+    (2 * (noOfChannels) * ((((uint32_t) ((sampleRate) / ((factor) * (callbackRate)))) + (factor) - 1) / (factor) * (factor)))
+
 /***************************************************************************************************
 ** PUBLIC FUNCTION DECLARATIONS
 ***************************************************************************************************/
 
 void ADCMonitorInit(ADC_HandleTypeDef* hadc, int16_t *pData, uint32_t length);
 void ADCMonitorLoop(ADCCallBack callback);
+void ADCMonitorLoopEx(ADCCallBackEx callback);
+void ADCMonitorGetTelemetry(ADCMonitorTelemetry_t *telemetry);
+void ADCMonitorResetTelemetry();
+const char* ADCMonitorStatus();
+int ADCMonitorSetDecimation(uint16_t factor, uint8_t shift, int16_t *pDecimated);
+void ADCMonitorSetPlanarBuffer(int16_t *pPlanar);
+const int16_t* ADCChannelSlice(uint16_t channel);
+int ADCDeinterleave(const int16_t *pData, int16_t *pDst);
 
+int ADCChannelStats(const int16_t *pData, uint16_t channel, ADCChannelStat_t *stats);
+int ADCFrameStats(const int16_t *pData, ADCChannelStat_t *stats);
 int16_t cmaAverage(int16_t *pData, uint16_t channel, int16_t cma, int k);
 double ADCrms(const int16_t *pData, uint16_t channel);
 double ADCTrueRms(const int16_t *pData, uint16_t channel, SineWaveIndexes_t indexes);
@@ -54,10 +170,25 @@ double ADCMean(const int16_t *pData, uint16_t channel);
 double ADCMeanLimited(const int16_t *pData, uint16_t channel, SineWaveIndexes_t indexes);
 float ADCMeanBitShift(const int16_t *pData, uint16_t channel, uint8_t shiftIdx);
 double ADCAbsMean(const int16_t *pData, uint16_t channel);
+float ADCrmsF(const int16_t *pData, uint16_t channel);
+float ADCTrueRmsF(const int16_t *pData, uint16_t channel, SineWaveIndexes_t indexes);
+float ADCMeanF(const int16_t *pData, uint16_t channel);
+float ADCMeanLimitedF(const int16_t *pData, uint16_t channel, SineWaveIndexes_t indexes);
+float ADCAbsMeanF(const int16_t *pData, uint16_t channel);
+int32_t ADCrmsQ(const int16_t *pData, uint16_t channel);
+int32_t ADCTrueRmsQ(const int16_t *pData, uint16_t channel, SineWaveIndexes_t indexes);
+int32_t ADCMeanQ(const int16_t *pData, uint16_t channel);
+int32_t ADCMeanLimitedQ(const int16_t *pData, uint16_t channel, SineWaveIndexes_t indexes);
+int32_t ADCAbsMeanQ(const int16_t *pData, uint16_t channel);
 int16_t ADCmax(const int16_t *pData, uint16_t channel);
 int16_t ADCmin(const int16_t *pData, uint16_t channel);
 void ADCSetOffset(int16_t* pData, int16_t offset, uint16_t channel);
 SineWaveIndexes_t sineWave(const int16_t* pData, uint32_t noOfChannels, uint32_t noOfSamples, uint16_t channel);
+void ADCZeroCrossInit(ADCZeroCross_t *zc, int16_t level, int16_t hysteresis);
+int ADCZeroCrossUpdate(ADCZeroCross_t *zc, const int16_t *pData, uint16_t channel, SineWaveIndexes_t *indexes);
+float ADCZeroCrossFrequency(const ADCZeroCross_t *zc, float sampleRate);
+void ADCCycleRmsInit(ADCCycleRms_t *acc, int16_t level, int16_t hysteresis, uint16_t cyclesPerResult);
+int ADCCycleRmsUpdate(ADCCycleRms_t *acc, const int16_t *pData, uint16_t channel);
 
 #ifdef __cplusplus
 }
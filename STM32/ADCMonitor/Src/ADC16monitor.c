@@ -12,6 +12,7 @@
 
 #include <math.h>
 #include <ADC16Monitor.h>
+#include "ADCsumMath.h"
 
 typedef enum {
     NotAvailable,
@@ -19,25 +20,225 @@ typedef enum {
     Second
 } activeBuffer_t;
 
-static struct {
+// One entry per ADC peripheral, see adcIndex.
+typedef struct ADCMonitorInstance {
+    ADC_HandleTypeDef *hadc;
     uint32_t   length;
     int32_t   *pData;        // DMA buffer
     uint32_t   noOfChannels; // No of channels for each sample
     uint32_t   noOfSamples;  // No of Samples in each channel per interrupt, half buffer.
 
+    volatile activeBuffer_t activeBuffer;
+    activeBuffer_t lastBuffer;  // Latest buffer passed to the callback
+
+    // Updated from the DMA interrupt
+    volatile uint32_t sequence;         // No of half buffers completed
+    volatile uint32_t isrCycles;        // Cycle count when the latest half buffer completed
+    volatile uint64_t timestamp;        // isrCycles extended to 64 bit
+    volatile uint32_t minPeriodCycles;  // Shortest interval between half buffers
+    volatile uint32_t maxPeriodCycles;  // Longest interval between half buffers
+} ADCMonitorInstance;
+
+static ADCMonitorInstance instances[ADC_MONITOR_MAX_INSTANCES];
+
+// Instance used by ADCMonitorInit/ADCMonitorLoop
+static ADCMonitorInstance *defaultInstance = &instances[0];
+
+// Table index of an ADC peripheral, giving constant time dispatch from the HAL callbacks.
+static int adcIndex(const ADC_HandleTypeDef* hadc)
+{
+#if defined(ADC3)
+    if (hadc->Instance == ADC3)
+        return 2;
+#endif
+#if defined(ADC2)
+    if (hadc->Instance == ADC2)
+        return 1;
+#endif
+    return 0;
+}
+
+// Finds the instance owning the DMA buffer pData points into. Buffers not owned by any instance
+// (e.g. a copy) are handled with the channel count of the default instance.
+static const ADCMonitorInstance* instanceOf(const int32_t* pData)
+{
+    for (int i = 0; i < ADC_MONITOR_MAX_INSTANCES; i++)
+    {
+        const ADCMonitorInstance *inst = &instances[i];
+        if (inst->pData != NULL && pData >= inst->pData && pData < &inst->pData[inst->length])
+            return inst;
+    }
+    return defaultInstance;
+}
+
+// Sum, sum of squares and absolute sum of a channel in the half buffer (min/max not computed).
+// Returns -1 if the buffer is not available or the arguments are invalid.
+static int channelSums(const int32_t* pData, uint16_t channel, ADCChannelStat_t* stats)
+{
+    const ADCMonitorInstance *inst = instanceOf(pData);
+    if (inst->activeBuffer == NotAvailable ||
+        pData == NULL ||
+        channel >= inst->noOfChannels ||
+        inst->noOfSamples == 0)
+    {
+        return -1;
+    }
+
+    int64_t  sum        = 0;
+    uint64_t sumSquares = 0;
+    uint64_t absSum     = 0;
+    for (uint32_t sampleId = 0; sampleId < inst->noOfSamples; sampleId++)
+    {
+        const int64_t sample = pData[sampleId*inst->noOfChannels + channel];
+        sum        += sample;
+        sumSquares += (uint64_t) (sample * sample);
+        absSum     += (uint64_t) ((sample < 0) ? -sample : sample);
+    }
+
+    stats->sum        = sum;
+    stats->sumSquares = sumSquares;
+    stats->absSum     = absSum;
+    stats->count      = inst->noOfSamples;
+    return 0;
+}
+
+// The DMA writes to memory behind the D-cache of the Cortex-M7. Discard any cached copy of a half
+// buffer, so the CPU reads what the DMA wrote. Lines made dirty by the callback (e.g. ADCSetOffset)
+// are discarded as well, so they are never written back over new DMA data.
+// Without a D-cache (or with it disabled) this is a no-op.
+static void invalidateHalf(const int32_t* pHalf, uint32_t noOfWords)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    SCB_InvalidateDCache_by_Addr((void *) pHalf, noOfWords * sizeof(int32_t));
+#else
+    (void) pHalf;
+    (void) noOfWords;
+#endif
+}
+
+// Registers a completed half buffer, called from the DMA interrupt.
+static void bufferReady(ADCMonitorInstance* inst, activeBuffer_t buffer)
+{
+    const uint32_t now = DWT->CYCCNT;
+
+    if (inst->sequence != 0)
+    {
+        const uint32_t period = now - inst->isrCycles;
+        if (period < inst->minPeriodCycles)
+            inst->minPeriodCycles = period;
+        if (period > inst->maxPeriodCycles)
+            inst->maxPeriodCycles = period;
+    }
+
+    // The counter wraps every 2^32 cycles, far less often than half buffers complete
+    uint64_t timestamp = (inst->timestamp & 0xFFFFFFFF00000000ULL) | now;
+    if (now < inst->isrCycles)
+        timestamp += 1ULL << 32;
+    inst->timestamp    = timestamp;
+    inst->isrCycles    = now;
+    inst->activeBuffer = buffer;
+    inst->sequence++;
+}
+
+// Implementation of the loop functions, callbackEx is used if not NULL.
+static void monitorLoop(ADCMonitorInstance* handle, ADCCallBack callback, ADCCallBackEx callbackEx)
+{
+    if (handle == NULL || handle->pData == NULL)
+        return;
+
+    // Consistent snapshot, read again if the DMA interrupt updated it meanwhile
+    ADCBufferInfo_t info;
     activeBuffer_t activeBuffer;
-} ADCMonitorData;
+    do
+    {
+        info.sequence  = handle->sequence;
+        info.timestamp = handle->timestamp;
+        activeBuffer   = handle->activeBuffer;
+    } while (info.sequence != handle->sequence);
 
-void ADCMonitorInit(ADC_HandleTypeDef* hadc, int32_t *pData, uint32_t length)
+    if (activeBuffer != handle->lastBuffer)
+    {
+        handle->lastBuffer = activeBuffer;
+        int32_t *pData = (activeBuffer == First)
+                ? handle->pData : &handle->pData[handle->length / 2];
+
+        invalidateHalf(pData, handle->length / 2);
+        if (callbackEx != NULL)
+            callbackEx(pData, handle->noOfChannels, handle->noOfSamples, &info);
+        else
+            callback(pData, handle->noOfChannels, handle->noOfSamples);
+        invalidateHalf(pData, handle->length / 2);
+    }
+}
+
+ADCMonitorHandle ADCMonitorInitHandle(ADC_HandleTypeDef* hadc, int32_t *pData, uint32_t length)
 {
+    ADCMonitorInstance *inst = &instances[adcIndex(hadc)];
+
     // Save internal data.
-    ADCMonitorData.pData           = pData;
-    ADCMonitorData.length          = length;
-    ADCMonitorData.noOfChannels    = hadc->Init.NbrOfConversion;
-    ADCMonitorData.noOfSamples     = length / (2 * hadc->Init.NbrOfConversion);
+    inst->hadc            = hadc;
+    inst->pData           = pData;
+    inst->length          = length;
+    inst->noOfChannels    = hadc->Init.NbrOfConversion;
+    inst->noOfSamples     = length / (2 * hadc->Init.NbrOfConversion);
+    inst->activeBuffer    = NotAvailable;
+    inst->lastBuffer      = NotAvailable;
+    inst->sequence        = 0;
+    inst->isrCycles       = 0;
+    inst->timestamp       = 0;
+    ADCMonitorResetJitter(inst);
+
+    // Enable the cycle counter used for the timestamps
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 
     // Write the registers
     HAL_ADC_Start_DMA(hadc, (uint32_t *) pData, length);
+
+    return inst;
+}
+
+void ADCMonitorInit(ADC_HandleTypeDef* hadc, int32_t *pData, uint32_t length)
+{
+    defaultInstance = ADCMonitorInitHandle(hadc, pData, length);
+}
+
+void ADCMonitorLoopHandle(ADCMonitorHandle handle, ADCCallBack callback)
+{
+    monitorLoop(handle, callback, NULL);
+}
+
+void ADCMonitorLoop(ADCCallBack callback)
+{
+    monitorLoop(defaultInstance, callback, NULL);
+}
+
+void ADCMonitorLoopHandleEx(ADCMonitorHandle handle, ADCCallBackEx callback)
+{
+    monitorLoop(handle, NULL, callback);
+}
+
+void ADCMonitorLoopEx(ADCCallBackEx callback)
+{
+    monitorLoop(defaultInstance, NULL, callback);
+}
+
+void ADCMonitorGetJitter(ADCMonitorHandle handle, uint32_t *minPeriodCycles, uint32_t *maxPeriodCycles)
+{
+    if (handle == NULL || minPeriodCycles == NULL || maxPeriodCycles == NULL)
+        return;
+
+    *minPeriodCycles = handle->minPeriodCycles;
+    *maxPeriodCycles = handle->maxPeriodCycles;
+}
+
+void ADCMonitorResetJitter(ADCMonitorHandle handle)
+{
+    if (handle == NULL)
+        return;
+
+    handle->minPeriodCycles = UINT32_MAX;
+    handle->maxPeriodCycles = 0;
 }
 
 int ADCCalibrationInit(ADC_HandleTypeDef* hadc, uint32_t CalibrationMode, uint32_t SingleDiff)
@@ -51,133 +252,228 @@ int ADCCalibrationInit(ADC_HandleTypeDef* hadc, uint32_t CalibrationMode, uint32
 
 int32_t cmaAvarage(int32_t *pData, uint16_t channel, int32_t cma, int k)
 {
-    for (uint32_t sampleId = 0; sampleId < ADCMonitorData.noOfSamples; sampleId++)
+    const ADCMonitorInstance *inst = instanceOf(pData);
+    for (uint32_t sampleId = 0; sampleId < inst->noOfSamples; sampleId++)
     {
         // cumulative moving average
-        int32_t* ptr = &pData[ADCMonitorData.noOfChannels * sampleId + channel];
+        int32_t* ptr = &pData[inst->noOfChannels * sampleId + channel];
         cma = cma + (*ptr - cma)/(k+1);
         *ptr = cma; // write in buffer
     }
     return cma;
 }
 
-void ADCMonitorLoop(ADCCallBack callback)
-{
-    static int lastBuffer = NotAvailable;
-
-    if (ADCMonitorData.activeBuffer != lastBuffer)
-    {
-        lastBuffer = ADCMonitorData.activeBuffer;
-        int32_t *pData = (ADCMonitorData.activeBuffer == First)
-                ? ADCMonitorData.pData : &ADCMonitorData.pData[ADCMonitorData.length / 2];
-        callback(pData, ADCMonitorData.noOfChannels, ADCMonitorData.noOfSamples);
-    }
-}
-
 double ADCrms(const int32_t *pData, uint16_t channel)
 {
-    if (ADCMonitorData.activeBuffer == NotAvailable ||
+    const ADCMonitorInstance *inst = instanceOf(pData);
+    if (inst->activeBuffer == NotAvailable ||
         pData == NULL ||
-        channel >= ADCMonitorData.noOfChannels)
+        channel >= inst->noOfChannels)
     {
         return 0;
     }
 
     uint64_t sum = 0;
-    for (uint32_t sampleId = 0; sampleId < ADCMonitorData.noOfSamples; sampleId++)
+    for (uint32_t sampleId = 0; sampleId < inst->noOfSamples; sampleId++)
     {
-        const int32_t mul = pData[sampleId*ADCMonitorData.noOfChannels + channel];
+        const int32_t mul = pData[sampleId*inst->noOfChannels + channel];
         sum += (mul * mul); // add squared values to sum
     }
 
-    return sqrt(((double) sum) / ((double)ADCMonitorData.noOfSamples));
+    return sqrt(((double) sum) / ((double)inst->noOfSamples));
 }
 
 double ADCMean(const int32_t *pData, uint16_t channel)
 {
-    if (ADCMonitorData.activeBuffer == NotAvailable ||
+    const ADCMonitorInstance *inst = instanceOf(pData);
+    if (inst->activeBuffer == NotAvailable ||
         pData == NULL ||
-        channel >= ADCMonitorData.noOfChannels)
+        channel >= inst->noOfChannels)
     {
         return 0;
     }
 
     uint64_t sum = 0;
-    for (uint32_t sampleId = 0; sampleId < ADCMonitorData.noOfSamples; sampleId++)
+    for (uint32_t sampleId = 0; sampleId < inst->noOfSamples; sampleId++)
     {
-        sum += pData[sampleId*ADCMonitorData.noOfChannels + channel];
+        sum += pData[sampleId*inst->noOfChannels + channel];
     }
 
-    return (((double) sum) / ((double) ADCMonitorData.noOfSamples));
+    return (((double) sum) / ((double) inst->noOfSamples));
 }
 
 float ADCMeanBitShift(const int32_t *pData, uint16_t channel, uint8_t shiftIdx)
 {
-	if (ADCMonitorData.activeBuffer == NotAvailable ||
+    const ADCMonitorInstance *inst = instanceOf(pData);
+	if (inst->activeBuffer == NotAvailable ||
 	        pData == NULL ||
-	        channel >= ADCMonitorData.noOfChannels)
+	        channel >= inst->noOfChannels)
 	{
 		return 0;
 	}
 
     uint32_t sum = 0;
-    for (uint32_t sampleId = 0; sampleId < ADCMonitorData.noOfSamples; sampleId++)
+    for (uint32_t sampleId = 0; sampleId < inst->noOfSamples; sampleId++)
     {
-        sum += pData[sampleId*ADCMonitorData.noOfChannels + channel];
+        sum += pData[sampleId*inst->noOfChannels + channel];
     }
     return (sum >> shiftIdx);
 }
 
 double ADCAbsMean(const int32_t *pData, uint16_t channel)
 {
-    if (ADCMonitorData.activeBuffer == NotAvailable ||
+    const ADCMonitorInstance *inst = instanceOf(pData);
+    if (inst->activeBuffer == NotAvailable ||
         pData == NULL ||
-        channel >= ADCMonitorData.noOfChannels)
+        channel >= inst->noOfChannels)
     {
         return 0;
     }
 
     uint64_t sum = 0;
-    for (uint32_t sampleId = 0; sampleId < ADCMonitorData.noOfSamples; sampleId++)
+    for (uint32_t sampleId = 0; sampleId < inst->noOfSamples; sampleId++)
     {
-        sum += abs(pData[sampleId*ADCMonitorData.noOfChannels + channel]);
+        sum += abs(pData[sampleId*inst->noOfChannels + channel]);
     }
 
-    return (sum / ADCMonitorData.noOfSamples);
+    return (sum / inst->noOfSamples);
 }
 
 uint32_t ADCmax(const int32_t *pData, uint16_t channel)
 {
-    if (ADCMonitorData.activeBuffer == NotAvailable ||
+    const ADCMonitorInstance *inst = instanceOf(pData);
+    if (inst->activeBuffer == NotAvailable ||
         pData == NULL ||
-        channel >= ADCMonitorData.noOfChannels)
+        channel >= inst->noOfChannels)
     {
         return 0;
     }
 
-    uint32_t max = 0;
-    for (uint32_t sampleId = 0; sampleId < ADCMonitorData.noOfSamples; sampleId++)
+    int32_t max = INT32_MIN;
+    for (uint32_t sampleId = 0; sampleId < inst->noOfSamples; sampleId++)
     {
-        int32_t sample = pData[sampleId*ADCMonitorData.noOfChannels + channel];
+        int32_t sample = pData[sampleId*inst->noOfChannels + channel];
         if (max < sample)
             max = sample;
     }
-    return max;
+    return (uint32_t) max;
+}
+
+int ADCFrameStats(const int32_t *pData, ADCChannelStat_t *stats)
+{
+    const ADCMonitorInstance *inst = instanceOf(pData);
+    if (inst->activeBuffer == NotAvailable ||
+        pData == NULL ||
+        stats == NULL ||
+        inst->noOfSamples == 0)
+    {
+        return -1;
+    }
+
+    const uint32_t noOfChannels = inst->noOfChannels;
+    for (uint32_t channel = 0; channel < noOfChannels; channel++)
+    {
+        memset(&stats[channel], 0, sizeof(stats[channel]));
+        stats[channel].min   = pData[channel];
+        stats[channel].max   = pData[channel];
+        stats[channel].count = inst->noOfSamples;
+    }
+
+    // Walk the buffer in memory order, one frame (a sample of each channel) at a time.
+    const int32_t *ptr = pData;
+    const int32_t *end = &pData[inst->noOfSamples * noOfChannels];
+    while (ptr < end)
+    {
+        ADCChannelStat_t *st = stats;
+        for (uint32_t channel = 0; channel < noOfChannels; channel++, ptr++, st++)
+        {
+            const int64_t sample = *ptr;
+            st->sum        += sample;
+            st->sumSquares += (uint64_t) (sample * sample);
+            st->absSum     += (uint64_t) ((sample < 0) ? -sample : sample);
+            if (sample < st->min)
+                st->min = sample;
+            if (sample > st->max)
+                st->max = sample;
+        }
+    }
+
+    return 0;
+}
+
+float ADCMeanF(const int32_t *pData, uint16_t channel)
+{
+    ADCChannelStat_t stats;
+    if (channelSums(pData, channel, &stats) != 0)
+        return 0;
+
+    return sumToFloat(stats.sum) / (float) stats.count;
+}
+
+float ADCAbsMeanF(const int32_t *pData, uint16_t channel)
+{
+    ADCChannelStat_t stats;
+    if (channelSums(pData, channel, &stats) != 0)
+        return 0;
+
+    return usumToFloat(stats.absSum) / (float) stats.count;
+}
+
+float ADCrmsF(const int32_t *pData, uint16_t channel)
+{
+    ADCChannelStat_t stats;
+    if (channelSums(pData, channel, &stats) != 0)
+        return 0;
+
+    return sqrtf(usumToFloat(stats.sumSquares) / (float) stats.count);
+}
+
+int32_t ADCMeanQ(const int32_t *pData, uint16_t channel)
+{
+    ADCChannelStat_t stats;
+    if (channelSums(pData, channel, &stats) != 0)
+        return 0;
+
+    return (int32_t) ((stats.sum * (1 << ADC_Q_FRAC_BITS)) / (int64_t) stats.count);
+}
+
+int32_t ADCAbsMeanQ(const int32_t *pData, uint16_t channel)
+{
+    ADCChannelStat_t stats;
+    if (channelSums(pData, channel, &stats) != 0)
+        return 0;
+
+    return (int32_t) ((stats.absSum << ADC_Q_FRAC_BITS) / stats.count);
+}
+
+int32_t ADCrmsQ(const int32_t *pData, uint16_t channel)
+{
+    ADCChannelStat_t stats;
+    if (channelSums(pData, channel, &stats) != 0)
+        return 0;
+
+    // Mean square with 2*ADC_Q_FRAC_BITS fractional bits, keep the precision unless it overflows
+    uint64_t meanSquare = (stats.sumSquares < (1ULL << (63 - 2*ADC_Q_FRAC_BITS)))
+            ? (stats.sumSquares << (2*ADC_Q_FRAC_BITS)) / stats.count
+            : (stats.sumSquares / stats.count) << (2*ADC_Q_FRAC_BITS);
+
+    return (int32_t) isqrt64(meanSquare);
 }
 
 void ADCSetOffset(int32_t* pData, int16_t offset, uint16_t channel)
 {
-    if (ADCMonitorData.activeBuffer == NotAvailable ||
+    const ADCMonitorInstance *inst = instanceOf(pData);
+    if (inst->activeBuffer == NotAvailable ||
         pData == NULL ||
-        channel >= ADCMonitorData.noOfChannels)
+        channel >= inst->noOfChannels)
     {
         return;
     }
 
-    for (uint32_t sampleId = 0; sampleId < ADCMonitorData.noOfSamples; sampleId++)
+    for (uint32_t sampleId = 0; sampleId < inst->noOfSamples; sampleId++)
     {
         // No need to addjust for overflow since ADC is 12 bits.
-        pData[sampleId*ADCMonitorData.noOfChannels + channel] += offset;
+        pData[sampleId*inst->noOfChannels + channel] += offset;
     }
 }
 
@@ -225,10 +521,10 @@ SineWave sineWave(const int32_t* pData, uint32_t noOfChannels, uint32_t noOfSamp
 
 void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc)
 {
-    ADCMonitorData.activeBuffer = First;
+    bufferReady(&instances[adcIndex(hadc)], First);
 }
 
 void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc)
 {
-    ADCMonitorData.activeBuffer = Second;
+    bufferReady(&instances[adcIndex(hadc)], Second);
 }
@@ -5,18 +5,15 @@
  * @author  Author: agp, timothe
 */
 
+#include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <math.h>
 
 #include "ADCMonitor.h"
-
-/***************************************************************************************************
-** PRIVATE FUNCTION DECLARATIONS
-***************************************************************************************************/
-
-static uint32_t sinePeakIdx(const int16_t* pData, uint32_t noOfChannels, uint32_t noOfSamples, uint16_t channel, bool reverse);
+#include "ADCsumMath.h"
 
 /***************************************************************************************************
 ** DEFINES
@@ -28,6 +25,40 @@ typedef enum {
     Second
 } activeBuffer_t;
 
+/* Dual 16 bit operations used by sumsKernel. On cores with the DSP extension (Cortex-M4/M7) these
+** map to single SIMD instructions, elsewhere (e.g. host unit tests) to bit-exact C equivalents. */
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    #define DSP_PACK(lo, hi)            __PKHBT((uint16_t) (lo), (uint32_t) (hi), 16)
+    #define DSP_SMLALD(x, y, acc)       __SMLALD((x), (y), (acc))
+#else
+    #define DSP_PACK(lo, hi)            ((uint32_t) (uint16_t) (lo) | ((uint32_t) (uint16_t) (hi) << 16))
+    #define DSP_SMLALD(x, y, acc)       ((acc) + (uint64_t) (int64_t) ((int32_t) (int16_t) (x) * (int16_t) (y)) \
+                                               + (uint64_t) (int64_t) ((int32_t) (int16_t) ((x) >> 16) * (int16_t) ((y) >> 16)))
+#endif
+
+/* Sign of both halfwords, 0xFFFF (-1) if negative else 0x0001. Plain C on all cores, the sign bits
+** are moved to bit 0 of each halfword so no carry crosses between them and no APSR.GE flags are
+** needed between instructions. */
+#define DSP_SIGN16(x)                   (0x00010001U + (((uint32_t) (x) >> 15) & 0x00010001U) * 0xFFFEU)
+
+/***************************************************************************************************
+** PRIVATE FUNCTION DECLARATIONS
+***************************************************************************************************/
+
+static uint32_t sinePeakIdx(const int16_t* pData, uint32_t noOfChannels, uint32_t noOfSamples, uint16_t channel, bool reverse);
+static void accumulateStats(const int16_t* pData, uint16_t channel, uint32_t begin, uint32_t end, ADCChannelStat_t* stats);
+static void sumsKernel(const int16_t* pData, uint32_t stride, uint32_t count, ADCChannelStat_t* stats);
+static void bufferReady(activeBuffer_t buffer);
+static void monitorLoop(ADCCallBack callback, ADCCallBackEx callbackEx);
+static bool risingCrossing(ADCZeroCross_t* zc, int32_t sample);
+static bool signalLost(ADCZeroCross_t* zc);
+static void crossingFound(ADCZeroCross_t* zc, float crossing);
+static void addCycleSamples(ADCCycleRms_t* acc, const int16_t* pData, uint32_t count);
+static bool decimate(const int16_t* pData);
+static int channelSums(const int16_t* pData, uint16_t channel, uint32_t begin, uint32_t end, ADCChannelStat_t* stats);
+static int32_t meanQ(const ADCChannelStat_t* stats);
+static int32_t rmsQ(const ADCChannelStat_t* stats);
+
 /***************************************************************************************************
 ** PRIVATE OBJECTS
 ***************************************************************************************************/
@@ -38,7 +69,30 @@ static struct {
     uint32_t   noOfChannels; // No of channels for each sample
     uint32_t   noOfSamples;  // No of Samples in each channel per interrupt, half buffer.
 
-    activeBuffer_t activeBuffer;
+    volatile activeBuffer_t activeBuffer; // Written by the DMA interrupt
+    int16_t   *pPlanar;      // Optional channel major copy of the latest half buffer
+
+    // Oversampling, see ADCMonitorSetDecimation
+    uint16_t   decimation;   // Samples summed into each decimated sample, 1 when disabled
+    uint8_t    shift;        // Right shift of the decimated sums
+    uint16_t   decimationIdx;// Half buffers in the decimated frame in progress
+    int16_t   *pDecimated;   // Decimated frame, same size as a half buffer
+
+    // Updated from the DMA interrupt
+    volatile uint32_t sequence;     // No of half buffers completed
+    volatile uint32_t isrCycles;    // Cycle count when the latest half buffer completed
+    volatile uint32_t periodCycles; // Cycles between the two latest half buffers
+    volatile uint32_t minPeriodCycles;
+    volatile uint32_t maxPeriodCycles;
+    volatile uint64_t timestamp;    // isrCycles extended to 64 bit
+
+    // Updated from ADCMonitorLoop
+    uint32_t lastSequence;          // Sequence of the latest half buffer passed to the callback
+    uint32_t dropped;
+    uint32_t overruns;
+    uint32_t callbackCycles;
+    uint32_t loadPermille;
+    uint32_t maxLoadPermille;
 } ADCMonitorData;
 
 /***************************************************************************************************
@@ -89,6 +143,360 @@ static uint32_t sinePeakIdx(const int16_t* pData, uint32_t noOfChannels, uint32_
     return (errIdx - channel)/noOfChannels;
 }
 
+/*!
+ * @brief   Gathers all statistics of a channel between two sample indexes in a single pass
+ * @param   pData Pointer to buffer
+ * @param   channel ADC channel
+ * @param   begin First sample index
+ * @param   end Last sample index (included)
+ * @param   stats Statistics of the channel (output)
+ * @note    Arguments are not validated, this is left to the caller
+*/
+static void accumulateStats(const int16_t* pData, uint16_t channel, uint32_t begin, uint32_t end, ADCChannelStat_t* stats)
+{
+    const uint32_t stride = ADCMonitorData.noOfChannels;
+    const int16_t *ptr = &pData[begin*stride + channel];
+
+    int64_t  sum        = 0;
+    uint64_t sumSquares = 0;
+    uint64_t absSum     = 0;
+    int16_t  min        = *ptr;
+    int16_t  max        = *ptr;
+
+    for (uint32_t sampleId = begin; sampleId <= end; sampleId++, ptr += stride)
+    {
+        const int32_t sample = *ptr;
+        sum        += sample;
+        sumSquares += (uint32_t) (sample * sample);
+        absSum     += (uint32_t) abs(sample);
+        if (sample < min)
+            min = sample;
+        if (sample > max)
+            max = sample;
+    }
+
+    stats->sum        = sum;
+    stats->sumSquares = sumSquares;
+    stats->absSum     = absSum;
+    stats->min        = min;
+    stats->max        = max;
+    stats->count      = end - begin + 1;
+}
+
+/*!
+ * @brief   Sum, sum of squares and absolute sum of a channel, two samples per step
+ * @param   pData Pointer to the first sample of the channel
+ * @param   stride Distance between two samples of the channel, i.e. the number of channels
+ * @param   count Number of samples
+ * @param   stats Statistics of the channel (output). min and max are not computed
+ * @note    Two samples are packed into one word and every statistic is accumulated with a single
+ *          dual 16 bit multiply accumulate into 64 bit (SMLALD). The absolute value is the sample
+ *          multiplied by its sign, which also makes -32768 exact.
+ * @note    Results are bit-exact with a one sample at a time loop, see adcmonitor_tests.cpp
+*/
+static void sumsKernel(const int16_t* pData, uint32_t stride, uint32_t count, ADCChannelStat_t* stats)
+{
+    uint64_t sum        = 0;
+    uint64_t sumSquares = 0;
+    uint64_t absSum     = 0;
+    const int16_t *ptr  = pData;
+
+    for (uint32_t pairs = count / 2; pairs > 0; pairs--, ptr += 2*stride)
+    {
+        const uint32_t pair = DSP_PACK(ptr[0], ptr[stride]);
+        sum        = DSP_SMLALD(pair, 0x00010001U, sum);
+        sumSquares = DSP_SMLALD(pair, pair, sumSquares);
+        absSum     = DSP_SMLALD(pair, DSP_SIGN16(pair), absSum);
+    }
+
+    if (count & 1)
+    {
+        const int32_t sample = *ptr;
+        sum        += (uint64_t) (int64_t) sample;
+        sumSquares += (uint32_t) (sample * sample);
+        absSum     += (uint32_t) abs(sample);
+    }
+
+    stats->sum        = (int64_t) sum;
+    stats->sumSquares = sumSquares;
+    stats->absSum     = absSum;
+    stats->count      = count;
+}
+
+/*!
+ * @brief   Registers a completed half buffer
+ * @param   buffer The half buffer that is ready
+ * @note    Called from the DMA interrupt
+*/
+static void bufferReady(activeBuffer_t buffer)
+{
+    const uint32_t now = DWT->CYCCNT;
+
+    if (ADCMonitorData.sequence != 0)
+    {
+        const uint32_t period = now - ADCMonitorData.isrCycles;
+        ADCMonitorData.periodCycles = period;
+        if (period < ADCMonitorData.minPeriodCycles)
+            ADCMonitorData.minPeriodCycles = period;
+        if (period > ADCMonitorData.maxPeriodCycles)
+            ADCMonitorData.maxPeriodCycles = period;
+    }
+
+    // The counter wraps every 2^32 cycles, far less often than half buffers complete
+    uint64_t timestamp = (ADCMonitorData.timestamp & 0xFFFFFFFF00000000ULL) | now;
+    if (now < ADCMonitorData.isrCycles)
+        timestamp += 1ULL << 32;
+    ADCMonitorData.timestamp    = timestamp;
+    ADCMonitorData.isrCycles    = now;
+    ADCMonitorData.activeBuffer = buffer;
+    ADCMonitorData.sequence++;
+}
+
+/*!
+ * @brief   Implementation of ADCMonitorLoop and ADCMonitorLoopEx
+ * @param   callback Callback without buffer info, used if callbackEx is NULL
+ * @param   callbackEx Callback with buffer info
+*/
+static void monitorLoop(ADCCallBack callback, ADCCallBackEx callbackEx)
+{
+    // Consistent snapshot of the latest half buffer, read again if the DMA interrupt updated it meanwhile
+    ADCBufferInfo_t info;
+    activeBuffer_t activeBuffer;
+    do
+    {
+        info.sequence  = ADCMonitorData.sequence;
+        info.timestamp = ADCMonitorData.timestamp;
+        activeBuffer   = ADCMonitorData.activeBuffer;
+    } while (info.sequence != ADCMonitorData.sequence);
+
+    const uint32_t sequence = info.sequence;
+
+    if (sequence != ADCMonitorData.lastSequence)
+    {
+        ADCMonitorData.dropped += sequence - ADCMonitorData.lastSequence - 1;
+        ADCMonitorData.lastSequence = sequence;
+
+        int16_t *pData = (activeBuffer == First)
+                ? ADCMonitorData.pData : &ADCMonitorData.pData[ADCMonitorData.length / 2];
+
+        const uint32_t start = DWT->CYCCNT;
+        bool frameReady = true;
+        if (ADCMonitorData.decimation > 1)
+        {
+            frameReady = decimate(pData);
+            pData = ADCMonitorData.pDecimated;
+        }
+
+        if (frameReady)
+        {
+            if (ADCMonitorData.pPlanar != NULL)
+            {
+                ADCDeinterleave(pData, ADCMonitorData.pPlanar);
+            }
+            if (callbackEx != NULL)
+            {
+                callbackEx(pData, ADCMonitorData.noOfChannels, ADCMonitorData.noOfSamples, &info);
+            }
+            else
+            {
+                callback(pData, ADCMonitorData.noOfChannels, ADCMonitorData.noOfSamples);
+            }
+        }
+        ADCMonitorData.callbackCycles = DWT->CYCCNT - start;
+
+        if (ADCMonitorData.sequence != sequence)
+        {
+            ADCMonitorData.overruns++;
+        }
+
+        const uint32_t period = ADCMonitorData.periodCycles;
+        if (period != 0)
+        {
+            ADCMonitorData.loadPermille = ((uint64_t) ADCMonitorData.callbackCycles * 1000) / period;
+            if (ADCMonitorData.loadPermille > ADCMonitorData.maxLoadPermille)
+            {
+                ADCMonitorData.maxLoadPermille = ADCMonitorData.loadPermille;
+            }
+        }
+    }
+}
+
+/*!
+ * @brief   Feeds one sample to a zero crossing detector
+ * @param   zc Detector state
+ * @param   sample Next sample of the channel
+ * @return  true if the signal crossed level rising between the previous sample and this one
+ * @note    zc->previous is updated to sample
+*/
+static bool risingCrossing(ADCZeroCross_t* zc, int32_t sample)
+{
+    bool crossing = false;
+
+    if (!zc->armed)
+    {
+        zc->armed = sample < (int32_t) zc->level - zc->hysteresis;
+    }
+    else if (sample >= zc->level && zc->hasPrevious)
+    {
+        crossing = true;
+        zc->armed = false;
+    }
+
+    zc->hasPrevious = true;
+    zc->previous = sample;
+    return crossing;
+}
+
+/*!
+ * @brief   Drops the lock of a detector that has not seen a crossing for too long
+ * @param   zc Detector state, lastCrossing relative to the start of the next half buffer
+ * @return  true if the lock was dropped
+ * @note    The signal is lost when no crossing is seen for two periods. Before the period is known
+ *          the first crossing is kept for up to maxPeriod samples, it may be longer than a half buffer.
+*/
+static bool signalLost(ADCZeroCross_t* zc)
+{
+    const float sinceCrossing = -zc->lastCrossing;
+    if (!zc->locked ||
+        (sinceCrossing <= zc->maxPeriod && (zc->period == 0 || sinceCrossing <= 2 * zc->period)))
+    {
+        return false;
+    }
+
+    zc->locked = false;
+    zc->period = 0;
+    return true;
+}
+
+/*!
+ * @brief   Registers a single rising crossing and updates the period from the previous one
+ * @param   zc Detector state, lastCrossing relative to the start of the current half buffer
+ * @param   crossing Interpolated crossing in samples relative to the start of the current half buffer
+*/
+static void crossingFound(ADCZeroCross_t* zc, float crossing)
+{
+    if (zc->locked)
+    {
+        zc->period = crossing - zc->lastCrossing;
+        zc->cycles++;
+    }
+    zc->lastCrossing = crossing;
+    zc->locked = true;
+}
+
+/*!
+ * @brief   Adds consecutive samples of a channel to the cycles in progress of a cycle accumulator
+ * @param   acc Cycle accumulator
+ * @param   pData Pointer to the first sample of the channel
+ * @param   count Number of samples
+*/
+static void addCycleSamples(ADCCycleRms_t* acc, const int16_t* pData, uint32_t count)
+{
+    if (count == 0)
+        return;
+
+    ADCChannelStat_t stats;
+    sumsKernel(pData, ADCMonitorData.noOfChannels, count, &stats);
+    acc->sum        += stats.sum;
+    acc->sumSquares += stats.sumSquares;
+    acc->count      += stats.count;
+}
+
+/*!
+ * @brief   Sums groups of ADCMonitorData.decimation samples of a half buffer into the decimated frame
+ * @param   pData Pointer to half buffer
+ * @return  true when the decimated frame is complete
+ * @note    The decimated frame keeps the interleaved layout of the half buffer
+*/
+static bool decimate(const int16_t* pData)
+{
+    const uint32_t noOfChannels = ADCMonitorData.noOfChannels;
+    const uint32_t factor       = ADCMonitorData.decimation;
+    const uint32_t outSamples   = ADCMonitorData.noOfSamples / factor;
+    const uint8_t  shift        = ADCMonitorData.shift;
+
+    int16_t *pDst = &ADCMonitorData.pDecimated[ADCMonitorData.decimationIdx * outSamples * noOfChannels];
+    int32_t sums[ADC_MAX_CHANNELS];
+
+    for (uint32_t out = 0; out < outSamples; out++)
+    {
+        memset(sums, 0, noOfChannels * sizeof(int32_t));
+
+        // Read the samples in memory order, all channels at a time
+        for (uint32_t i = 0; i < factor; i++, pData += noOfChannels)
+        {
+            for (uint32_t ch = 0; ch < noOfChannels; ch++)
+            {
+                sums[ch] += pData[ch];
+            }
+        }
+
+        for (uint32_t ch = 0; ch < noOfChannels; ch++, pDst++)
+        {
+            const int32_t value = sums[ch] >> shift;
+            *pDst = (value > INT16_MAX) ? INT16_MAX : (value < INT16_MIN) ? INT16_MIN : value;
+        }
+    }
+
+    if (++ADCMonitorData.decimationIdx < factor)
+    {
+        return false;
+    }
+
+    ADCMonitorData.decimationIdx = 0;
+    return true;
+}
+
+/*!
+ * @brief   Validates the arguments of a statistic and sums a channel between two sample indexes
+ * @param   pData Pointer to buffer
+ * @param   channel ADC channel
+ * @param   begin First sample index
+ * @param   end Last sample index (included)
+ * @param   stats Statistics of the channel (output). min and max are not computed
+ * @return  0 on success, -1 if the buffer is not available or the arguments are invalid
+*/
+static int channelSums(const int16_t* pData, uint16_t channel, uint32_t begin, uint32_t end, ADCChannelStat_t* stats)
+{
+    if (ADCMonitorData.activeBuffer == NotAvailable ||
+        pData == NULL ||
+        channel >= ADCMonitorData.noOfChannels ||
+        begin > end ||
+        end >= ADCMonitorData.noOfSamples)
+    {
+        return -1;
+    }
+
+    sumsKernel(&pData[begin*ADCMonitorData.noOfChannels + channel], ADCMonitorData.noOfChannels,
+               end - begin + 1, stats);
+    return 0;
+}
+
+/*!
+ * @brief   Mean of summed samples
+ * @param   stats Sums of a channel
+ * @return  Mean with ADC_Q_FRAC_BITS fractional bits, rounded towards zero
+*/
+static int32_t meanQ(const ADCChannelStat_t* stats)
+{
+    return (int32_t) ((stats->sum * (1 << ADC_Q_FRAC_BITS)) / (int64_t) stats->count);
+}
+
+/*!
+ * @brief   RMS of summed samples
+ * @param   stats Sums of a channel
+ * @return  RMS with ADC_Q_FRAC_BITS fractional bits, rounded down
+*/
+static int32_t rmsQ(const ADCChannelStat_t* stats)
+{
+    // Mean square with 2*ADC_Q_FRAC_BITS fractional bits, keep the precision unless it overflows
+    uint64_t meanSquare = (stats->sumSquares < (1ULL << (63 - 2*ADC_Q_FRAC_BITS)))
+            ? (stats->sumSquares << (2*ADC_Q_FRAC_BITS)) / stats->count
+            : (stats->sumSquares / stats->count) << (2*ADC_Q_FRAC_BITS);
+
+    return (int32_t) isqrt64(meanSquare);
+}
+
 /***************************************************************************************************
 ** PUBLIC FUNCTION DEFINITIONS
 ***************************************************************************************************/
@@ -108,6 +516,22 @@ void ADCMonitorInit(ADC_HandleTypeDef* hadc, int16_t *pData, uint32_t length)
     ADCMonitorData.length          = length;
     ADCMonitorData.noOfChannels    = hadc->Init.NbrOfConversion;
     ADCMonitorData.noOfSamples     = length / (2 * hadc->Init.NbrOfConversion);
+    ADCMonitorData.activeBuffer    = NotAvailable;
+    ADCMonitorData.sequence        = 0;
+    ADCMonitorData.lastSequence    = 0;
+    ADCMonitorData.periodCycles    = 0;
+    ADCMonitorData.timestamp       = 0;
+    ADCMonitorData.isrCycles       = 0;
+    ADCMonitorData.pPlanar         = NULL;
+    ADCMonitorData.decimation      = 1;
+    ADCMonitorData.shift           = 0;
+    ADCMonitorData.decimationIdx   = 0;
+    ADCMonitorData.pDecimated      = NULL;
+    ADCMonitorResetTelemetry();
+
+    // Enable the cycle counter used for the processing budget telemetry
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 
     // Write the registers
     HAL_ADC_Start_DMA(hadc, (uint32_t *) pData, length);
@@ -120,18 +544,189 @@ void ADCMonitorInit(ADC_HandleTypeDef* hadc, int16_t *pData, uint32_t length)
  *
  * @param   callback Callback function called when the buffer is full or half-full
  * @note    Must be called from from while(1) loop to get info about new buffer via ADCCallBack function
+ * @note    Half buffers completed since the previous call, other than the latest, are counted as
+ *          dropped. If the DMA completes another half buffer while the callback runs, the data
+ *          passed to the callback has been overwritten and an overrun is counted.
+ * @note    When decimating (ADCMonitorSetDecimation) the callback gets the decimated frame every
+ *          decimation half buffers instead of the half buffer.
 */
 void ADCMonitorLoop(ADCCallBack callback)
 {
-    static int lastBuffer = NotAvailable;
+    monitorLoop(callback, NULL);
+}
+
+/*!
+ * @brief   As ADCMonitorLoop, the callback also gets the sequence number and timestamp of the buffer
+ * @param   callback Callback function called when the buffer is full or half-full
+*/
+void ADCMonitorLoopEx(ADCCallBackEx callback)
+{
+    monitorLoop(NULL, callback);
+}
 
-    if (ADCMonitorData.activeBuffer != lastBuffer)
+/*!
+ * @brief   Gives the throughput telemetry of the ADC monitor
+ * @param   telemetry Telemetry (output)
+*/
+void ADCMonitorGetTelemetry(ADCMonitorTelemetry_t *telemetry)
+{
+    if (telemetry == NULL)
     {
-        lastBuffer = ADCMonitorData.activeBuffer;
-        int16_t *pData = (ADCMonitorData.activeBuffer == First)
-                ? ADCMonitorData.pData : &ADCMonitorData.pData[ADCMonitorData.length / 2];
-        callback(pData, ADCMonitorData.noOfChannels, ADCMonitorData.noOfSamples);
+        return;
+    }
+
+    telemetry->sequence        = ADCMonitorData.sequence;
+    telemetry->dropped         = ADCMonitorData.dropped;
+    telemetry->overruns        = ADCMonitorData.overruns;
+    telemetry->periodCycles    = ADCMonitorData.periodCycles;
+    telemetry->minPeriodCycles = ADCMonitorData.minPeriodCycles;
+    telemetry->maxPeriodCycles = ADCMonitorData.maxPeriodCycles;
+    telemetry->callbackCycles  = ADCMonitorData.callbackCycles;
+    telemetry->loadPermille    = ADCMonitorData.loadPermille;
+    telemetry->maxLoadPermille = ADCMonitorData.maxLoadPermille;
+}
+
+/*!
+ * @brief   Clears the dropped/overrun counters, the processing load and the period jitter of the ADC monitor
+ * @note    The sequence number is not reset
+*/
+void ADCMonitorResetTelemetry()
+{
+    ADCMonitorData.dropped         = 0;
+    ADCMonitorData.overruns        = 0;
+    ADCMonitorData.callbackCycles  = 0;
+    ADCMonitorData.loadPermille    = 0;
+    ADCMonitorData.maxLoadPermille = 0;
+    ADCMonitorData.minPeriodCycles = UINT32_MAX;
+    ADCMonitorData.maxPeriodCycles = 0;
+}
+
+/*!
+ * @brief   ADC monitor telemetry for the board status message
+ * @return  Null terminated line describing the ADC throughput
+ * @note    Printed by CAPrintStatus when ADCMonitor is linked into the application
+*/
+const char* ADCMonitorStatus()
+{
+    static char buf[128]; // static to prevent allocate on stack.
+
+    snprintf(buf, sizeof(buf),
+             "ADC buffers: %" PRIu32 ", dropped: %" PRIu32 ", overruns: %" PRIu32
+             ", load: %" PRIu32 ".%" PRIu32 "%% (max %" PRIu32 ".%" PRIu32 "%%)\r\n",
+             ADCMonitorData.sequence, ADCMonitorData.dropped, ADCMonitorData.overruns,
+             ADCMonitorData.loadPermille / 10, ADCMonitorData.loadPermille % 10,
+             ADCMonitorData.maxLoadPermille / 10, ADCMonitorData.maxLoadPermille % 10);
+
+    return buf;
+}
+
+/*!
+ * @brief   Enables oversampling with decimation in ADCMonitorLoop
+ *
+ *          Every factor consecutive samples of a channel are summed into one decimated sample,
+ *          which is right shifted by shift bits. Summing 4^n samples and shifting n bits gives n
+ *          extra effective bits, e.g. factor 16 and shift 2 turns 12 bit samples into 14 bit.
+ *          The decimated frames have the layout and size of a half buffer, so the callback and
+ *          the statistics functions are used unchanged, but the callback is only called every
+ *          factor half buffers. See ADC_DECIMATION_DMA_LENGTH for sizing the DMA buffer.
+ *
+ * @param   factor Decimation factor, 1 to disable. Must divide the number of samples in a half buffer
+ * @param   shift Right shift of the sums, results are saturated to 16 bit
+ * @param   pDecimated Buffer of noOfChannels * noOfSamples (half buffer) samples
+ * @return  0 on success, -1 if the arguments are invalid or there are more than ADC_MAX_CHANNELS
+ *          channels
+ * @note    Must be called after ADCMonitorInit
+*/
+int ADCMonitorSetDecimation(uint16_t factor, uint8_t shift, int16_t *pDecimated)
+{
+    if (factor == 0 ||
+        shift > 31 ||
+        (factor > 1 && pDecimated == NULL) ||
+        (factor > 1 && ADCMonitorData.noOfChannels > ADC_MAX_CHANNELS) ||
+        ADCMonitorData.noOfSamples % factor != 0)
+    {
+        return -1;
+    }
+
+    ADCMonitorData.decimation    = factor;
+    ADCMonitorData.shift         = shift;
+    ADCMonitorData.decimationIdx = 0;
+    ADCMonitorData.pDecimated    = pDecimated;
+    return 0;
+}
+
+/*!
+ * @brief   Enables the planar stage of ADCMonitorLoop
+ *
+ *          Before each callback the half buffer is transposed into pPlanar, so every channel is
+ *          available as a contiguous array through ADCChannelSlice. Contiguous slices can be given
+ *          to the strided consumers (e.g. hanning()) with noOfChannels = 1 and channel = 0.
+ *
+ * @param   pPlanar Buffer of noOfChannels * noOfSamples (half buffer) samples, NULL to disable
+ * @note    Must be called after ADCMonitorInit
+*/
+void ADCMonitorSetPlanarBuffer(int16_t *pPlanar)
+{
+    ADCMonitorData.pPlanar = pPlanar;
+}
+
+/*!
+ * @brief   Contiguous samples of a channel in the latest half buffer
+ * @param   channel ADC channel
+ * @return  noOfSamples samples of the channel, NULL if the planar stage is not enabled
+*/
+const int16_t* ADCChannelSlice(uint16_t channel)
+{
+    if (ADCMonitorData.pPlanar == NULL ||
+        channel >= ADCMonitorData.noOfChannels)
+    {
+        return NULL;
+    }
+
+    return &ADCMonitorData.pPlanar[channel * ADCMonitorData.noOfSamples];
+}
+
+/*!
+ * @brief   Transposes a half buffer into channel major order
+ * @param   pData Pointer to buffer, [CH0{s0}, CH1{s0},,, CHN{s0}, CH0{s1},,,]
+ * @param   pDst Destination of noOfChannels * noOfSamples samples, [CH0{s0}, CH0{s1},,, CH1{s0},,,]
+ * @return  0 on success, -1 if the arguments are invalid
+ * @note    The transpose is done in blocks of ADC_DEINTERLEAVE_BLOCK samples per channel
+*/
+int ADCDeinterleave(const int16_t *pData, int16_t *pDst)
+{
+    if (pData == NULL || pDst == NULL)
+    {
+        return -1;
+    }
+
+    const uint32_t noOfChannels = ADCMonitorData.noOfChannels;
+    const uint32_t noOfSamples  = ADCMonitorData.noOfSamples;
+
+    if (noOfChannels == 1)
+    {
+        memcpy(pDst, pData, noOfSamples * sizeof(*pData));
+        return 0;
+    }
+
+    for (uint32_t block = 0; block < noOfSamples; block += ADC_DEINTERLEAVE_BLOCK)
+    {
+        const uint32_t blockLength = (noOfSamples - block < ADC_DEINTERLEAVE_BLOCK)
+                                   ? noOfSamples - block : ADC_DEINTERLEAVE_BLOCK;
+
+        for (uint32_t channel = 0; channel < noOfChannels; channel++)
+        {
+            const int16_t *src = &pData[block * noOfChannels + channel];
+            int16_t *dst = &pDst[channel * noOfSamples + block];
+
+            for (uint32_t i = 0; i < blockLength; i++, src += noOfChannels)
+            {
+                dst[i] = *src;
+            }
+        }
     }
+
+    return 0;
 }
 
 /*!
@@ -154,6 +749,81 @@ int16_t cmaAverage(int16_t *pData, uint16_t channel, int16_t cma, int k)
     return cma;
 }
 
+/*!
+ * @brief   Statistics computation on whole buffer for selected channel in a single pass
+ * @param   pData Pointer to buffer
+ * @param   channel ADC channel
+ * @param   stats Statistics of the channel (output)
+ * @return  0 on success, -1 if the buffer is not available or the arguments are invalid
+*/
+int ADCChannelStats(const int16_t *pData, uint16_t channel, ADCChannelStat_t *stats)
+{
+    if (stats == NULL)
+    {
+        return -1;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    if (ADCMonitorData.activeBuffer == NotAvailable ||
+        pData == NULL ||
+        channel >= ADCMonitorData.noOfChannels ||
+        ADCMonitorData.noOfSamples == 0)
+    {
+        return -1;
+    }
+
+    accumulateStats(pData, channel, 0, ADCMonitorData.noOfSamples - 1, stats);
+    return 0;
+}
+
+/*!
+ * @brief   Statistics computation on whole buffer for all channels in a single pass
+ * @param   pData Pointer to buffer
+ * @param   stats Array with one entry per channel, noOfChannels as given by ADCMonitorInit (output)
+ * @return  0 on success, -1 if the buffer is not available or the arguments are invalid
+ * @note    The buffer is read sequentially in memory order instead of once per channel with a
+ *          stride of noOfChannels
+*/
+int ADCFrameStats(const int16_t *pData, ADCChannelStat_t *stats)
+{
+    if (ADCMonitorData.activeBuffer == NotAvailable ||
+        pData == NULL ||
+        stats == NULL ||
+        ADCMonitorData.noOfSamples == 0)
+    {
+        return -1;
+    }
+
+    const uint32_t noOfChannels = ADCMonitorData.noOfChannels;
+    for (uint32_t channel = 0; channel < noOfChannels; channel++)
+    {
+        memset(&stats[channel], 0, sizeof(stats[channel]));
+        stats[channel].min   = pData[channel];
+        stats[channel].max   = pData[channel];
+        stats[channel].count = ADCMonitorData.noOfSamples;
+    }
+
+    const int16_t *ptr = pData;
+    const int16_t *end = &pData[ADCMonitorData.noOfSamples * noOfChannels];
+    while (ptr < end)
+    {
+        ADCChannelStat_t *st = stats;
+        for (uint32_t channel = 0; channel < noOfChannels; channel++, ptr++, st++)
+        {
+            const int32_t sample = *ptr;
+            st->sum        += sample;
+            st->sumSquares += (uint32_t) (sample * sample);
+            st->absSum     += (uint32_t) abs(sample);
+            if (sample < st->min)
+                st->min = sample;
+            if (sample > st->max)
+                st->max = sample;
+        }
+    }
+
+    return 0;
+}
+
 /*!
  * @brief   RMS computation on whole buffer for selected channel
  * @param   pData Pointer to buffer
@@ -163,19 +833,16 @@ double ADCrms(const int16_t *pData, uint16_t channel)
 {
     if (ADCMonitorData.activeBuffer == NotAvailable ||
         pData == NULL ||
-        channel >= ADCMonitorData.noOfChannels)
+        channel >= ADCMonitorData.noOfChannels ||
+        ADCMonitorData.noOfSamples == 0)
     {
         return 0;
     }
 
-    uint64_t sum = 0;
-    for (uint32_t sampleId = 0; sampleId < ADCMonitorData.noOfSamples; sampleId++)
-    {
-        const int16_t mul = pData[sampleId*ADCMonitorData.noOfChannels + channel];
-        sum += (mul * mul); // add squared values to sum
-    }
+    ADCChannelStat_t stats;
+    sumsKernel(&pData[channel], ADCMonitorData.noOfChannels, ADCMonitorData.noOfSamples, &stats);
 
-    return sqrt(((double) sum) / ((double)ADCMonitorData.noOfSamples));
+    return sqrt(((double) stats.sumSquares) / ((double) stats.count));
 }
 
 /*!
@@ -195,14 +862,11 @@ double ADCTrueRms(const int16_t *pData, uint16_t channel, SineWaveIndexes_t inde
         return 0;
     }
 
-    uint64_t sum = 0;
-    for (uint32_t sampleId = indexes.begin; sampleId <= indexes.end; sampleId++)
-    {
-        const int16_t mul = pData[sampleId*ADCMonitorData.noOfChannels + channel];
-        sum += (mul * mul); // add squared values to sum
-    }
+    ADCChannelStat_t stats;
+    sumsKernel(&pData[indexes.begin*ADCMonitorData.noOfChannels + channel], ADCMonitorData.noOfChannels,
+               indexes.end - indexes.begin + 1, &stats);
 
-    return sqrt(((double) sum) / ((double) (indexes.end - indexes.begin + 1)));
+    return sqrt(((double) stats.sumSquares) / ((double) stats.count));
 }
 
 /*!
@@ -214,18 +878,16 @@ double ADCMean(const int16_t *pData, uint16_t channel)
 {
     if (ADCMonitorData.activeBuffer == NotAvailable ||
         pData == NULL ||
-        channel >= ADCMonitorData.noOfChannels)
+        channel >= ADCMonitorData.noOfChannels ||
+        ADCMonitorData.noOfSamples == 0)
     {
         return 0;
     }
 
-    uint64_t sum = 0;
-    for (uint32_t sampleId = 0; sampleId < ADCMonitorData.noOfSamples; sampleId++)
-    {
-        sum += pData[sampleId*ADCMonitorData.noOfChannels + channel];
-    }
+    ADCChannelStat_t stats;
+    sumsKernel(&pData[channel], ADCMonitorData.noOfChannels, ADCMonitorData.noOfSamples, &stats);
 
-    return (((double) sum) / ((double) ADCMonitorData.noOfSamples));
+    return (((double) stats.sum) / ((double) stats.count));
 }
 
 /*!
@@ -245,13 +907,11 @@ double ADCMeanLimited(const int16_t *pData, uint16_t channel, SineWaveIndexes_t
         return 0;
     }
 
-    uint64_t sum = 0;
-    for (uint32_t sampleId = indexes.begin; sampleId <= indexes.end; sampleId++)
-    {
-        sum += pData[sampleId*ADCMonitorData.noOfChannels + channel];
-    }
+    ADCChannelStat_t stats;
+    sumsKernel(&pData[indexes.begin*ADCMonitorData.noOfChannels + channel], ADCMonitorData.noOfChannels,
+               indexes.end - indexes.begin + 1, &stats);
 
-    return (((double) sum) / ((double) (indexes.end - indexes.begin + 1)));
+    return (((double) stats.sum) / ((double) stats.count));
 }
 
 /*!
@@ -288,18 +948,16 @@ double ADCAbsMean(const int16_t *pData, uint16_t channel)
 {
     if (ADCMonitorData.activeBuffer == NotAvailable ||
         pData == NULL ||
-        channel >= ADCMonitorData.noOfChannels)
+        channel >= ADCMonitorData.noOfChannels ||
+        ADCMonitorData.noOfSamples == 0)
     {
         return 0;
     }
 
-    uint64_t sum = 0;
-    for (uint32_t sampleId = 0; sampleId < ADCMonitorData.noOfSamples; sampleId++)
-    {
-        sum += abs(pData[sampleId*ADCMonitorData.noOfChannels + channel]);
-    }
+    ADCChannelStat_t stats;
+    sumsKernel(&pData[channel], ADCMonitorData.noOfChannels, ADCMonitorData.noOfSamples, &stats);
 
-    return ( ((double) sum) / ((double) ADCMonitorData.noOfSamples) );
+    return ( ((double) stats.absSum) / ((double) stats.count) );
 }
 
 /*!
@@ -309,21 +967,13 @@ double ADCAbsMean(const int16_t *pData, uint16_t channel)
 */
 int16_t ADCmax(const int16_t *pData, uint16_t channel)
 {
-    if (ADCMonitorData.activeBuffer == NotAvailable ||
-        pData == NULL ||
-        channel >= ADCMonitorData.noOfChannels)
+    ADCChannelStat_t stats;
+    if (ADCChannelStats(pData, channel, &stats) != 0)
     {
         return 0;
     }
 
-    int16_t max = pData[channel];
-    for (uint32_t sampleId = 1; sampleId < ADCMonitorData.noOfSamples; sampleId++)
-    {
-        int16_t sample = pData[sampleId*ADCMonitorData.noOfChannels + channel];
-        if (max < sample)
-            max = sample;
-    }
-    return max;
+    return stats.max;
 }
 
 /*!
@@ -333,21 +983,190 @@ int16_t ADCmax(const int16_t *pData, uint16_t channel)
 */
 int16_t ADCmin(const int16_t *pData, uint16_t channel)
 {
-    if (ADCMonitorData.activeBuffer == NotAvailable ||
-        pData == NULL ||
-        channel >= ADCMonitorData.noOfChannels)
+    ADCChannelStat_t stats;
+    if (ADCChannelStats(pData, channel, &stats) != 0)
     {
         return 0;
     }
 
-    int16_t min = pData[channel];
-    for (uint32_t sampleId = 1; sampleId < ADCMonitorData.noOfSamples; sampleId++)
+    return stats.min;
+}
+
+/*!
+ * @brief   Single precision version of ADCrms
+ * @param   pData Pointer to buffer
+ * @param   channel ADC channel
+ * @note    Uses sqrtf, i.e. the FPU of Cortex-M4F/M7 instead of double precision library calls.
+ *          The 64 bit sums are reduced to 32 bits before the conversion to float (see
+ *          usumToFloat), the results of the F functions are accurate to float precision.
+*/
+float ADCrmsF(const int16_t *pData, uint16_t channel)
+{
+    ADCChannelStat_t stats;
+    if (channelSums(pData, channel, 0, ADCMonitorData.noOfSamples - 1, &stats) != 0)
     {
-        int16_t sample = pData[sampleId*ADCMonitorData.noOfChannels + channel];
-        if (min > sample)
-            min = sample;
+        return 0;
+    }
+
+    return sqrtf(usumToFloat(stats.sumSquares) / (float) stats.count);
+}
+
+/*!
+ * @brief   Single precision version of ADCTrueRms
+ * @param   pData Pointer to buffer
+ * @param   channel ADC channel
+ * @param   indexes Begin and end indexes (both included)
+*/
+float ADCTrueRmsF(const int16_t *pData, uint16_t channel, SineWaveIndexes_t indexes)
+{
+    ADCChannelStat_t stats;
+    if (indexes.begin >= indexes.end ||
+        channelSums(pData, channel, indexes.begin, indexes.end, &stats) != 0)
+    {
+        return 0;
+    }
+
+    return sqrtf(usumToFloat(stats.sumSquares) / (float) stats.count);
+}
+
+/*!
+ * @brief   Single precision version of ADCMean
+ * @param   pData Pointer to buffer
+ * @param   channel ADC channel
+*/
+float ADCMeanF(const int16_t *pData, uint16_t channel)
+{
+    ADCChannelStat_t stats;
+    if (channelSums(pData, channel, 0, ADCMonitorData.noOfSamples - 1, &stats) != 0)
+    {
+        return 0;
+    }
+
+    return sumToFloat(stats.sum) / (float) stats.count;
+}
+
+/*!
+ * @brief   Single precision version of ADCMeanLimited
+ * @param   pData Pointer to buffer
+ * @param   channel ADC channel
+ * @param   indexes Begin and end indexes (both included)
+*/
+float ADCMeanLimitedF(const int16_t *pData, uint16_t channel, SineWaveIndexes_t indexes)
+{
+    ADCChannelStat_t stats;
+    if (indexes.begin >= indexes.end ||
+        channelSums(pData, channel, indexes.begin, indexes.end, &stats) != 0)
+    {
+        return 0;
+    }
+
+    return sumToFloat(stats.sum) / (float) stats.count;
+}
+
+/*!
+ * @brief   Single precision version of ADCAbsMean
+ * @param   pData Pointer to buffer
+ * @param   channel ADC channel
+*/
+float ADCAbsMeanF(const int16_t *pData, uint16_t channel)
+{
+    ADCChannelStat_t stats;
+    if (channelSums(pData, channel, 0, ADCMonitorData.noOfSamples - 1, &stats) != 0)
+    {
+        return 0;
+    }
+
+    return usumToFloat(stats.absSum) / (float) stats.count;
+}
+
+/*!
+ * @brief   Fixed point version of ADCrms
+ * @param   pData Pointer to buffer
+ * @param   channel ADC channel
+ * @return  RMS with ADC_Q_FRAC_BITS fractional bits, 0 on error
+ * @note    Integer only, the square root is isqrt64
+*/
+int32_t ADCrmsQ(const int16_t *pData, uint16_t channel)
+{
+    ADCChannelStat_t stats;
+    if (channelSums(pData, channel, 0, ADCMonitorData.noOfSamples - 1, &stats) != 0)
+    {
+        return 0;
+    }
+
+    return rmsQ(&stats);
+}
+
+/*!
+ * @brief   Fixed point version of ADCTrueRms
+ * @param   pData Pointer to buffer
+ * @param   channel ADC channel
+ * @param   indexes Begin and end indexes (both included)
+ * @return  RMS with ADC_Q_FRAC_BITS fractional bits, 0 on error
+*/
+int32_t ADCTrueRmsQ(const int16_t *pData, uint16_t channel, SineWaveIndexes_t indexes)
+{
+    ADCChannelStat_t stats;
+    if (indexes.begin >= indexes.end ||
+        channelSums(pData, channel, indexes.begin, indexes.end, &stats) != 0)
+    {
+        return 0;
+    }
+
+    return rmsQ(&stats);
+}
+
+/*!
+ * @brief   Fixed point version of ADCMean
+ * @param   pData Pointer to buffer
+ * @param   channel ADC channel
+ * @return  Mean with ADC_Q_FRAC_BITS fractional bits, 0 on error
+*/
+int32_t ADCMeanQ(const int16_t *pData, uint16_t channel)
+{
+    ADCChannelStat_t stats;
+    if (channelSums(pData, channel, 0, ADCMonitorData.noOfSamples - 1, &stats) != 0)
+    {
+        return 0;
+    }
+
+    return meanQ(&stats);
+}
+
+/*!
+ * @brief   Fixed point version of ADCMeanLimited
+ * @param   pData Pointer to buffer
+ * @param   channel ADC channel
+ * @param   indexes Begin and end indexes (both included)
+ * @return  Mean with ADC_Q_FRAC_BITS fractional bits, 0 on error
+*/
+int32_t ADCMeanLimitedQ(const int16_t *pData, uint16_t channel, SineWaveIndexes_t indexes)
+{
+    ADCChannelStat_t stats;
+    if (indexes.begin >= indexes.end ||
+        channelSums(pData, channel, indexes.begin, indexes.end, &stats) != 0)
+    {
+        return 0;
+    }
+
+    return meanQ(&stats);
+}
+
+/*!
+ * @brief   Fixed point version of ADCAbsMean
+ * @param   pData Pointer to buffer
+ * @param   channel ADC channel
+ * @return  Mean of the absolute samples with ADC_Q_FRAC_BITS fractional bits, 0 on error
+*/
+int32_t ADCAbsMeanQ(const int16_t *pData, uint16_t channel)
+{
+    ADCChannelStat_t stats;
+    if (channelSums(pData, channel, 0, ADCMonitorData.noOfSamples - 1, &stats) != 0)
+    {
+        return 0;
     }
-    return min;
+
+    return (int32_t) ((stats.absSum << ADC_Q_FRAC_BITS) / stats.count);
 }
 
 /*!
@@ -389,13 +1208,237 @@ SineWaveIndexes_t sineWave(const int16_t* pData, uint32_t noOfChannels, uint32_t
     return result;
 }
 
+/*!
+ * @brief   Initialise a streaming zero crossing detector
+ * @param   zc Detector state, one for each monitored channel
+ * @param   level Crossing level, e.g. the offset of the signal
+ * @param   hysteresis Distance below level the signal must reach before a new crossing is accepted
+ * @note    zc->maxPeriod is set to ADC_ZERO_CROSS_MAX_PERIOD and may be changed after the call
+*/
+void ADCZeroCrossInit(ADCZeroCross_t *zc, int16_t level, int16_t hysteresis)
+{
+    if (zc == NULL)
+        return;
+
+    memset(zc, 0, sizeof(ADCZeroCross_t));
+    zc->level = level;
+    zc->hysteresis = (hysteresis < 0) ? 0 : hysteresis;
+    zc->maxPeriod = ADC_ZERO_CROSS_MAX_PERIOD;
+}
+
+/*!
+ * @brief   Find rising crossings of a channel in the latest half buffer and update period and phase
+ * @param   zc Detector state
+ * @param   pData Pointer to the latest half buffer, must be called for every half buffer in order
+ * @param   channel ADC channel
+ * @param   indexes Set to the samples from the first to the last crossing in the half buffer, i.e. a
+ *          whole number of periods for ADCTrueRms/ADCMeanLimited. {0, 0} if less than two crossings.
+ *          May be NULL.
+ * @return  Number of crossings in the half buffer, -1 on error
+ * @note    Replaces sineWave. Crossings are tracked across half buffers, so the period is also
+ *          found when the half buffer holds less than a whole period.
+*/
+int ADCZeroCrossUpdate(ADCZeroCross_t *zc, const int16_t *pData, uint16_t channel, SineWaveIndexes_t *indexes)
+{
+    if (indexes != NULL)
+    {
+        indexes->begin = 0;
+        indexes->end = 0;
+    }
+
+    if (zc == NULL ||
+        pData == NULL ||
+        ADCMonitorData.activeBuffer == NotAvailable ||
+        channel >= ADCMonitorData.noOfChannels)
+    {
+        return -1;
+    }
+
+    const uint32_t noOfChannels = ADCMonitorData.noOfChannels;
+    const uint32_t noOfSamples = ADCMonitorData.noOfSamples;
+
+    int crossings = 0;
+    uint32_t firstIdx = 0;
+    uint32_t lastIdx = 0;
+    float firstCrossing = 0;
+    float lastCrossing = 0;
+
+    for (uint32_t i = 0; i < noOfSamples; i++)
+    {
+        const int32_t previous = zc->previous;
+        const int32_t sample = pData[i*noOfChannels + channel];
+
+        if (risingCrossing(zc, sample))
+        {
+            // previous < level <= sample, interpolate between sample i-1 and i
+            float crossing = (float) i - 1.0f + (float) (zc->level - previous) / (float) (sample - previous);
+
+            if (crossings == 0)
+            {
+                firstIdx = i;
+                firstCrossing = crossing;
+            }
+            lastIdx = i;
+            lastCrossing = crossing;
+            crossings++;
+        }
+    }
+
+    if (crossings == 0)
+    {
+        zc->lastCrossing -= noOfSamples;
+
+        signalLost(zc);
+        return 0;
+    }
+
+    // Include the cycle across the half buffer boundary when the previous crossing is known
+    float start = (zc->locked) ? zc->lastCrossing : firstCrossing;
+    uint32_t periods = (zc->locked) ? crossings : crossings - 1;
+    if (periods != 0)
+    {
+        zc->period = (lastCrossing - start) / periods;
+        zc->cycles += periods;
+    }
+
+    if (zc->period > 0)
+    {
+        float phase = -lastCrossing / zc->period;
+        zc->phase = phase - floorf(phase);
+    }
+
+    zc->lastCrossing = lastCrossing - noOfSamples;
+    zc->locked = true;
+
+    if (indexes != NULL && crossings > 1)
+    {
+        indexes->begin = firstIdx;
+        indexes->end = lastIdx - 1;
+    }
+
+    return crossings;
+}
+
+/*!
+ * @brief   Initialise a true RMS accumulator over whole cycles
+ * @param   acc Accumulator state, one for each monitored channel
+ * @param   level Crossing level used to find the cycles, e.g. the offset of the signal
+ * @param   hysteresis Distance below level the signal must reach before a new crossing is accepted
+ * @param   cyclesPerResult Number of complete cycles in each result
+*/
+void ADCCycleRmsInit(ADCCycleRms_t *acc, int16_t level, int16_t hysteresis, uint16_t cyclesPerResult)
+{
+    if (acc == NULL)
+        return;
+
+    memset(acc, 0, sizeof(ADCCycleRms_t));
+    ADCZeroCrossInit(&acc->zc, level, hysteresis);
+    acc->cyclesPerResult = (cyclesPerResult == 0) ? 1 : cyclesPerResult;
+}
+
+/*!
+ * @brief   Accumulate a channel of the latest half buffer into whole cycles
+ * @param   acc Accumulator state
+ * @param   pData Pointer to the latest half buffer, must be called for every half buffer in order
+ * @param   channel ADC channel
+ * @return  Number of results completed in the half buffer (normally 0 or 1), -1 on error
+ * @note    Sums are carried across half buffers, so every sample between two result boundaries
+ *          is used exactly once regardless of the buffer length. Samples before the first
+ *          rising crossing are discarded. The latest result is in acc->rms and acc->mean.
+ * @note    acc->zc tracks period and phase like ADCZeroCrossUpdate. When the signal is lost (see
+ *          ADCZeroCross_t maxPeriod) the cycles in progress are discarded and detection restarts.
+*/
+int ADCCycleRmsUpdate(ADCCycleRms_t *acc, const int16_t *pData, uint16_t channel)
+{
+    if (acc == NULL ||
+        pData == NULL ||
+        ADCMonitorData.activeBuffer == NotAvailable ||
+        channel >= ADCMonitorData.noOfChannels)
+    {
+        return -1;
+    }
+
+    const uint32_t noOfChannels = ADCMonitorData.noOfChannels;
+    const uint32_t noOfSamples = ADCMonitorData.noOfSamples;
+    const int16_t *pChannel = &pData[channel];
+    ADCZeroCross_t *zc = &acc->zc;
+    uint32_t segmentBegin = 0;
+    int results = 0;
+
+    for (uint32_t i = 0; i < noOfSamples; i++)
+    {
+        const int32_t previous = zc->previous;
+        const int32_t sample = pChannel[i*noOfChannels];
+        if (!risingCrossing(zc, sample))
+            continue;
+
+        // Sample i is the first sample of a new cycle
+        const bool wasLocked = zc->locked;
+        crossingFound(zc, (float) i - 1.0f + (float) (zc->level - previous) / (float) (sample - previous));
+        if (wasLocked)
+        {
+            addCycleSamples(acc, &pChannel[segmentBegin*noOfChannels], i - segmentBegin);
+            if (++acc->cycles >= acc->cyclesPerResult)
+            {
+                acc->rms  = sqrtf(usumToFloat(acc->sumSquares) / (float) acc->count);
+                acc->mean = sumToFloat(acc->sum) / (float) acc->count;
+                acc->results++;
+                results++;
+
+                acc->sum        = 0;
+                acc->sumSquares = 0;
+                acc->count      = 0;
+                acc->cycles     = 0;
+            }
+        }
+        segmentBegin = i;
+    }
+
+    if (zc->locked)
+    {
+        addCycleSamples(acc, &pChannel[segmentBegin*noOfChannels], noOfSamples - segmentBegin);
+
+        if (zc->period > 0)
+        {
+            float phase = -zc->lastCrossing / zc->period;
+            zc->phase = phase - floorf(phase);
+        }
+        zc->lastCrossing -= noOfSamples;
+    }
+
+    // Drop the partial cycles of a lost signal, so a result never spans a gap
+    if (signalLost(zc))
+    {
+        acc->sum        = 0;
+        acc->sumSquares = 0;
+        acc->count      = 0;
+        acc->cycles     = 0;
+    }
+
+    return results;
+}
+
+/*!
+ * @brief   Frequency of the signal tracked by a zero crossing detector
+ * @param   zc Detector state
+ * @param   sampleRate Samples per second of each channel
+ * @return  Frequency in Hz, 0 if unknown
+*/
+float ADCZeroCrossFrequency(const ADCZeroCross_t *zc, float sampleRate)
+{
+    if (zc == NULL || zc->period <= 0)
+        return 0;
+
+    return sampleRate / zc->period;
+}
+
 /*!
  * @brief   Overwritten callback function for ADC buffer half-full
  * @param   hadc Pointer to ADC handler
 */
 void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc)
 {
-    ADCMonitorData.activeBuffer = First;
+    bufferReady(First);
 }
 
 /*!
@@ -404,5 +1447,5 @@ void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc)
 */
 void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc)
 {
-    ADCMonitorData.activeBuffer = Second;
+    bufferReady(Second);
 }
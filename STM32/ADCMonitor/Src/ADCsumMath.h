@@ -0,0 +1,70 @@
+/*!
+ * @file    ADCsumMath.h
+ * @brief   Conversions of channel sums shared by ADCmonitor.c and ADC16monitor.c
+ * @date    16/10/2026
+ * @note    Internal header, only included by the monitor sources
+*/
+
+#ifndef _ADCSUMMATH_H_
+#define _ADCSUMMATH_H_
+
+#include <stdint.h>
+
+/*!
+ * @brief   Integer square root, rounded down
+ * @param   value Radicand
+ * @return  floor(sqrt(value))
+ * @note    One result bit per iteration, no division and no floating point
+*/
+static inline uint32_t isqrt64(uint64_t value)
+{
+    uint64_t root = 0;
+    uint64_t bit  = 1ULL << 62;
+
+    while (bit > value)
+        bit >>= 2;
+
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t) root;
+}
+
+/*!
+ * @brief   Converts an unsigned sum to float without the 64 bit soft-float conversion
+ * @param   sum Sum of a channel
+ * @return  sum rounded to float
+ * @note    The sum is shifted down to 32 bits, which the FPU converts in one instruction. At least
+ *          24 significant bits are kept, so the result has float precision for any sum.
+*/
+static inline float usumToFloat(uint64_t sum)
+{
+    float scale = 1.0f;
+    while (sum > UINT32_MAX)
+    {
+        sum >>= 8;
+        scale *= 256.0f;
+    }
+    return (float) (uint32_t) sum * scale;
+}
+
+/*!
+ * @brief   Signed version of usumToFloat
+*/
+static inline float sumToFloat(int64_t sum)
+{
+    return (sum < 0) ? -usumToFloat(-(uint64_t) sum) : usumToFloat((uint64_t) sum);
+}
+
+#endif /* _ADCSUMMATH_H_ */
@@ -12,6 +12,10 @@ extern "C" {
 
 CA_rfft_ctx* ca_rfft_init(uint16_t fftLen);
 q15_t* ca_rfft(CA_rfft_ctx* ctx, int16_t* pData, int noOfChannels, int noOfSamples, int channel);
+// FFT of contiguous samples of a single channel, e.g. ADCChannelSlice. fftLen samples are copied
+// to a work area of the context, pData is not modified. The work area is allocated on the first
+// call, NULL is returned if that fails.
+q15_t* ca_rfft_contiguous(CA_rfft_ctx* ctx, const q15_t* pData);
 int ca_rfft_absmax(q15_t* table, size_t size, q15_t* x, q15_t* y);
 
 #ifdef __cplusplus
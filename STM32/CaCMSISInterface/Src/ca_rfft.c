@@ -1,11 +1,21 @@
 #include <ca_rfft.h>
 #include <stdlib.h>
+#include <string.h>
 
 struct CA_rfft_ctx_ {
     arm_rfft_instance_q15 rfftq15;
+    uint16_t fftLen;
+    q15_t* workTable;  // Input copy for ca_rfft_contiguous, allocated on its first call
     q15_t* outTable;
 };
 
+static q15_t* transform(CA_rfft_ctx* ctx, q15_t* work) {
+    // arm_rfft_q15 uses the source buffer as work area.
+    arm_rfft_q15(&ctx->rfftq15, work, ctx->outTable);
+
+    return ctx->outTable;
+}
+
 CA_rfft_ctx* ca_rfft_init(uint16_t fftLen) {
     CA_rfft_ctx* ctx = calloc(1, sizeof(CA_rfft_ctx));
 
@@ -14,6 +24,7 @@ CA_rfft_ctx* ca_rfft_init(uint16_t fftLen) {
     if (ret == ARM_MATH_SUCCESS) {
         // Output buffer is double the size to enable support for bit shifting in FFT algorithms.
         ctx->outTable = (q15_t*)calloc(2 * fftLen, sizeof(q15_t));
+        ctx->fftLen = fftLen;
         if (ctx->outTable == NULL) {
             free(ctx);
             ctx = NULL;
@@ -35,9 +46,26 @@ q15_t* ca_rfft(CA_rfft_ctx* ctx, int16_t* pData, int noOfChannels, int noOfSampl
     for (int i = 0; i < noOfSamples; i++) {
         inTable[i] = pData[i * noOfChannels + chOffset];
     }
-    arm_rfft_q15(&ctx->rfftq15, inTable, ctx->outTable);
 
-    return ctx->outTable;
+    return transform(ctx, inTable);
+}
+
+q15_t* ca_rfft_contiguous(CA_rfft_ctx* ctx, const q15_t* pData) {
+    if (ctx == NULL || pData == NULL) {
+        return NULL;
+    }
+
+    // Only contexts used with contiguous input pay for the work area.
+    if (ctx->workTable == NULL) {
+        ctx->workTable = (q15_t*)malloc(ctx->fftLen * sizeof(q15_t));
+        if (ctx->workTable == NULL) {
+            return NULL;
+        }
+    }
+
+    // The samples are copied so pData, e.g. a slice shared with other users, is left intact.
+    memcpy(ctx->workTable, pData, ctx->fftLen * sizeof(q15_t));
+    return transform(ctx, ctx->workTable);
 }
 
 int ca_rfft_absmax(q15_t* table, size_t size, q15_t* x, q15_t* y) {
@@ -24,6 +24,11 @@ void initCrc8(uint8_t init, uint8_t poly);
 uint8_t crc8Calculate(uint8_t *data, size_t len);
 uint8_t crc4Calculate(uint8_t *data, size_t len);
 
+// CRC-16/CCITT-FALSE (poly 0x1021, MSB first). Start with crc = CRC16_INIT, pass the result of
+// the previous call to continue over several blocks.
+#define CRC16_INIT 0xFFFFU
+uint16_t crc16Calculate(uint16_t crc, const uint8_t *data, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -81,3 +81,20 @@ uint8_t crc4Calculate(uint8_t *data, size_t len)
 
     return crc & 0xFU;
 }
+
+/*!
+** @brief Calculates CRC-16/CCITT-FALSE, continuing from crc
+*/
+uint16_t crc16Calculate(uint16_t crc, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (int j = 0; j < 8; j++) {
+            if ((crc & 0x8000) != 0)
+                crc = (uint16_t)((crc << 1) ^ 0x1021U);
+            else
+                crc <<= 1;
+        }
+    }
+    return crc;
+}
@@ -12,6 +12,7 @@
 #include <stdint.h>
 
 #include "StmGpio.h"
+#include "outStream.h"
 #include "stm32f4xx_hal.h"
 
 /***************************************************************************************************
@@ -42,6 +43,7 @@ typedef struct {
     bool rxReady;                     // Becomes true when new command is received
     uint32_t lastRxTime;              // Timestamp of last command
     char *txBuf;                      // Micro-controller tx buffer
+    uint16_t txLen;                   // Bytes written to txBuf by the output stream, 0 if txBuf is a string
     bool txReady;                     // Becomes true when a line is ready (10 Hz)
     bool stopADCPrint;                // To stop 10 Hz ADC print when Status/StatusDef/Serial
     socket_t sockets[NO_OF_SOCKETS];  // Sockets of the ethernet port
@@ -64,5 +66,6 @@ void sendGratuitousARP(ethernet_t *heth);
 int W5500Init(ethernet_t *heth, SPI_HandleTypeDef *hspi, GPIO_TypeDef *port, uint16_t pin,
               netInfo_t netInfo, char *txBuf, char *rxBuf);
 int W5500TCPServer(ethernet_t *heth);
+void W5500OutStreamInit(ethernet_t *heth, OutStream_t *stream);
 
 #endif /* INC_W5500_H_ */
@@ -269,6 +269,7 @@ static void chipUnselect(ethernet_t *heth);
 static void readBurst(ethernet_t *heth, uint8_t *buff, uint16_t len);
 static void writeBurst(ethernet_t *heth, uint8_t *buff, uint16_t len);
 static uint8_t readByte(ethernet_t *heth);
+static void discardStreamTx(ethernet_t *heth);
 
 // From W5500 library file
 uint8_t WIZCHIP_READ(ethernet_t *heth, uint32_t AddrSel);
@@ -1066,6 +1067,7 @@ int W5500Init(ethernet_t *heth, SPI_HandleTypeDef *hspi, GPIO_TypeDef *port, uin
     heth->rxBuf      = rxBuf;
     heth->rxReady    = false;
     heth->txBuf      = txBuf;
+    heth->txLen      = 0;
     heth->txReady    = false;
     heth->lastRxTime = 0;
 
@@ -1115,8 +1117,10 @@ int W5500TCPServer(ethernet_t *heth) {
                 // If this is the active socket, handle communication
                 if (socketId == heth->activeSocket) {
                     if (heth->txReady) {
-                        send(heth, socketId, (uint8_t *)heth->txBuf, strlen(heth->txBuf));
+                        uint16_t len = (heth->txLen != 0) ? heth->txLen : strlen(heth->txBuf);
+                        send(heth, socketId, (uint8_t *)heth->txBuf, len);
                         heth->txReady = false;
+                        heth->txLen   = 0;
                     }
 
                     // If the RX buffer contains data, receive it
@@ -1137,9 +1141,15 @@ int W5500TCPServer(ethernet_t *heth) {
                 // Disconnect the client and reset the active socket
                 disconnect(heth, socketId);
                 heth->activeSocket = INVALID_SOCKET;
+                discardStreamTx(heth);
                 break;
 
             case SOCK_CLOSED:
+                // The client is gone if the active socket closed without CLOSE_WAIT, e.g. reset
+                if (socketId == heth->activeSocket) {
+                    heth->activeSocket = INVALID_SOCKET;
+                    discardStreamTx(heth);
+                }
                 // Open a new TCP socket to listen for new clients
                 socket(heth, socketId, PORT);
                 break;
@@ -1157,3 +1167,68 @@ int W5500TCPServer(ethernet_t *heth) {
 
     return ret;
 }
+
+/*!
+ * @brief   Drops the output stream data waiting in txBuf, so it is not sent to the next client
+ */
+static void discardStreamTx(ethernet_t *heth) {
+    if (heth->txLen != 0) {
+        heth->txLen    = 0;
+        heth->txBuf[0] = '\0';
+        heth->txReady  = false;
+    }
+}
+
+static ssize_t W5500StreamWrite(void *ctx, const uint8_t *buf, size_t len) {
+    ethernet_t *heth = (ethernet_t *)ctx;
+
+    // Nobody to send it to, dropped as if sent. Fan-outs keep writing to their other streams.
+    if (heth->activeSocket == INVALID_SOCKET) {
+        discardStreamTx(heth);
+        return (ssize_t)len;
+    }
+
+    // Appended to the pending line, sent by W5500TCPServer after flush
+    size_t space = TCP_BUF_LEN - 1 - heth->txLen;
+    if (len > space) {
+        len = space;
+    }
+    memcpy(&heth->txBuf[heth->txLen], buf, len);
+    heth->txLen += len;
+    heth->txBuf[heth->txLen] = '\0';
+
+    return (ssize_t)len;
+}
+
+static size_t W5500StreamAvailable(void *ctx) {
+    ethernet_t *heth = (ethernet_t *)ctx;
+
+    if (heth->activeSocket == INVALID_SOCKET) {
+        return SIZE_MAX; // Writes are dropped
+    }
+    return TCP_BUF_LEN - 1 - heth->txLen;
+}
+
+static int W5500StreamFlush(void *ctx) {
+    ethernet_t *heth = (ethernet_t *)ctx;
+
+    if (heth->txLen != 0) {
+        heth->txReady = true;
+    }
+    return 0;
+}
+
+/*!
+ * @brief   Makes stream an output stream to the active TCP client of heth
+ * @note    Writes fill txBuf (TCP_BUF_LEN bytes), flush marks it ready to be sent by W5500TCPServer.
+ *          While no client is connected writes are dropped and report all bytes accepted, data
+ *          still waiting when the client disconnects is dropped too.
+ * @param   heth Ethernet handler, initialised by W5500Init
+ * @param   stream Stream to initialise
+ */
+void W5500OutStreamInit(ethernet_t *heth, OutStream_t *stream) {
+    stream->write     = W5500StreamWrite;
+    stream->available = W5500StreamAvailable;
+    stream->flush     = W5500StreamFlush;
+    stream->ctx       = heth;
+}
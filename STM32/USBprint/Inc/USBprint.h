@@ -9,11 +9,15 @@
 #define INC_USBPRINT_H_
 
 #include <unistd.h>
+#include <stdarg.h>
 #include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 
+#include "binaryStream.h"
+#include "outStream.h"
+
 /**
  * @brief Adds a formatted string at the end of a buffer
  * @param b Buffer
@@ -22,14 +26,26 @@
  */
 #define CA_SNPRINTF(b, l, ...) l += snprintf(&b[l], sizeof(b) - l, __VA_ARGS__)
 
-// Wrap vsnprintf(char *str, size_t size, const char *format, va_list ap)
-// and send data to USB port. The n indicates that buffer overflow is handled.
-// String/n is max 256 bytes.
+// printf to the USB port. The output is formatted straight into the transmit buffers, there is
+// no line length limit. The n indicates that buffer overflow is handled: returns the number of
+// bytes accepted, less than the formatted length if the transmit buffers are full (counted as
+// dropped, see usbTxCounters). -1 on error.
 int USBnprintf(const char * format, ... );
+int USBvprintf(const char * format, va_list args);
 
 // Same interface ansi C write, same return values.
 ssize_t writeUSB(const void *buf, size_t count);
 
+// Write function of csvInitWrite, builds CSV data lines straight to the USB port:
+//   csvInitWrite(&csv, buf, sizeof(buf), usbCsvWrite, NULL);
+void usbCsvWrite(void *ctx, const char *data, size_t len);
+
+// Sends the channels of hdr->channelMask from an interleaved ADC buffer as one binary frame, see
+// binaryStream.h. Use usbTxFlowControl(true, ...) so a frame is either sent whole or dropped.
+// Returns the number of bytes written as writeUSB, -1 if the frame is larger than the transmit
+// buffer or invalid.
+ssize_t usbStreamAdc(const BStreamHeader_t *hdr, const int16_t *pBuffer, int noOfChannels, const float *scale);
+
 // Return the number of bytes possible to write to buffer.
 size_t txAvailable();
 
@@ -37,8 +53,45 @@ bool isUsbPortOpen();
 
 int usbRx(uint8_t* buf);
 
+// Copies the next complete received line, without its terminator, into buf and NUL terminates it.
+// Lines longer than size - 1 are cut. Returns the line length, 0 if no complete line has arrived.
+int usbRxLine(uint8_t* buf, size_t size);
+
 void usbFlush();
 
+// Coalescing of many small writes into fewer USB packets. With timeoutUs != 0 written data is
+// sent when a packet is full, on usbTxFlush, or once it has waited timeoutUs. The timeout is
+// checked on writes and in usbTxPoll, which must be called from the main loop.
+// 0 turns coalescing off, every write is sent at once (default).
+void usbTxCoalesce(uint32_t timeoutUs);
+int usbTxFlush();
+void usbTxPoll();
+
+// Flow control of the transmit buffer. With allOrNothing a write that does not fit completely is
+// rejected (returns 0, isUsbError reports CDC_ERROR_TX_FULL) instead of being cut. watermark(true)
+// is called when the buffer fill reaches highWatermark bytes, watermark(false) when it has fallen
+// to lowWatermark, from writes and usbTxPoll. usbTxThrottled tells if the fill is above the
+// watermarks. highWatermark = 0 turns the watermarks off. Default is no flow control.
+void usbTxFlowControl(bool allOrNothing, size_t lowWatermark, size_t highWatermark, void (*watermark)(bool high));
+bool usbTxThrottled();
+
+// Counters of the transmit path since start or usbTxCountersReset.
+typedef struct {
+    uint32_t queued;    // Bytes accepted by writes
+    uint32_t sent;      // Bytes handed to the USB stack
+    uint32_t dropped;   // Bytes rejected or cut as the transmit buffer was full
+    uint32_t packets;   // USB packets sent
+    uint32_t retries;   // Transfers that failed to start and were retried
+    uint32_t peakFill;  // Highest fill of the transmit buffer in bytes
+} UsbTxCounters;
+
+void usbTxCounters(UsbTxCounters *counters);
+void usbTxCountersReset();
+
 uint32_t isUsbError();
 
+// Makes stream an output stream to the USB port, e.g. for a fan-out with other transports.
+// Writes behave as writeUSB, flush as usbTxFlush.
+void usbOutStreamInit(OutStream_t *stream);
+
 #endif /* INC_USBPRINT_H_ */
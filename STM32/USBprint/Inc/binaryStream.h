@@ -0,0 +1,89 @@
+/*!
+** @file   binaryStream.h
+** @brief  Binary framed streaming of ADC samples, an alternative to CSV lines for high channel
+**         counts and rates. Each frame is COBS encoded and ends with a 0 byte, so the host can
+**         resynchronise on any 0 byte after lost or corrupt data.
+**
+**         Decoded frame, all fields little endian:
+**           [0]  version       uint8   BSTREAM_VERSION
+**           [1]  format        uint8   BStreamFormat_t
+**           [2]  noOfSamples   uint16  Samples of each channel
+**           [4]  sequence      uint32  Increments by one per frame from the source, gaps are lost frames
+**           [8]  timestamp     uint64  E.g. the cycle counter of ADCBufferInfo_t
+**           [16] channelMask   uint32  Bit n set if channel n is in the frame
+**           [20] samples               Channel interleaved, the set bits of channelMask in order
+**           [..] crc           uint16  CRC-16/CCITT-FALSE of all the bytes above
+** @date   15/10/2026
+*/
+
+#ifndef BINARY_STREAM_H_
+#define BINARY_STREAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+/***************************************************************************************************
+** DEFINES
+***************************************************************************************************/
+
+#define BSTREAM_VERSION     1
+#define BSTREAM_HEADER_SIZE 20
+#define BSTREAM_CRC_SIZE    2
+
+// Encoded size of a frame with payloadLen bytes of samples, including the COBS overhead and the
+// 0 delimiter.
+#define BSTREAM_FRAME_SIZE(payloadLen) \
+    (BSTREAM_HEADER_SIZE + (payloadLen) + BSTREAM_CRC_SIZE + \
+     (BSTREAM_HEADER_SIZE + (payloadLen) + BSTREAM_CRC_SIZE) / 254 + 2)
+
+/***************************************************************************************************
+** PUBLIC TYPES
+***************************************************************************************************/
+
+typedef enum {
+    BSTREAM_INT16 = 0,      // Raw ADC samples
+    BSTREAM_FLOAT32 = 1,    // Samples multiplied by a scale per channel, IEEE 754 single precision
+} BStreamFormat_t;
+
+typedef struct {
+    uint8_t format;         // BStreamFormat_t
+    uint16_t noOfSamples;   // Samples of each channel
+    uint32_t sequence;
+    uint64_t timestamp;
+    uint32_t channelMask;   // Bit n set if channel n is in the frame, at most 32 channels
+} BStreamHeader_t;
+
+/***************************************************************************************************
+** PUBLIC FUNCTION DECLARATIONS
+***************************************************************************************************/
+
+// Encodes the channels of hdr->channelMask from an interleaved ADC buffer
+// [CH0{s0}, CH1{s0},,, CHN{s0}, CH0{s1},,, CHN{sM}] of noOfChannels as one frame into dst.
+// BSTREAM_FLOAT32 sends pBuffer[i] * scale[channel], scale is not used for BSTREAM_INT16.
+// Returns the frame length including the 0 delimiter, 0 if the frame does not fit in size or the
+// header is invalid.
+size_t bstreamEncode(uint8_t *dst, size_t size, const BStreamHeader_t *hdr, const int16_t *pBuffer,
+                     int noOfChannels, const float *scale);
+
+// Reference decoder for the host. frame is one received frame without its 0 delimiter, it is
+// decoded in place. Samples are stored channel interleaved as float for both formats.
+// Returns the number of samples, -1 if the frame is corrupt or has more than maxSamples samples.
+int bstreamDecode(uint8_t *frame, size_t len, BStreamHeader_t *hdr, float *samples, size_t maxSamples);
+
+// COBS encoding of len bytes into dst, without the 0 delimiter. dst must hold len + len / 254 + 1.
+// Returns the encoded length.
+size_t cobsEncode(const uint8_t *src, size_t len, uint8_t *dst);
+
+// COBS decoding of len bytes without the 0 delimiter into dst, which may be src.
+// Returns the decoded length, -1 if the input is not valid COBS.
+int cobsDecode(const uint8_t *src, size_t len, uint8_t *dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BINARY_STREAM_H_ */
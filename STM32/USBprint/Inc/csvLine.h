@@ -0,0 +1,75 @@
+/*!
+** @file   csvLine.h
+** @brief  Builder of comma separated data lines without printf. Integers and fixed point values
+**         are formatted by hand with integer arithmetic only, the output is identical to the
+**         printf conversions given for each function.
+** @date   15/10/2026
+*/
+
+#ifndef CSV_LINE_H_
+#define CSV_LINE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "vformat.h"
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+/***************************************************************************************************
+** DEFINES
+***************************************************************************************************/
+
+#define CSV_SEPARATOR       ", "
+#define CSV_LINE_END        "\r\n"
+#define CSV_MAX_DECIMALS    9
+#define CSV_FIELD_MAX       64  // Longest single field, separator included
+
+/***************************************************************************************************
+** PUBLIC TYPES
+***************************************************************************************************/
+
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;         // Bytes in buf
+    size_t total;       // Bytes of the line, including those already passed to write
+    bool overflow;      // A field did not fit in buf and was dropped
+    vformatWrite write; // NULL if the line is built in buf, else where buf is flushed when full
+    void *ctx;
+} CsvLine_t;
+
+/***************************************************************************************************
+** PUBLIC FUNCTION DECLARATIONS
+***************************************************************************************************/
+
+// Starts a line in buf. The line is kept zero terminated, a field that does not fit is dropped
+// and the line marked as overflowed. Call again to start the next line.
+void csvInit(CsvLine_t *csv, char *buf, size_t size);
+
+// Starts a line that is passed to write, e.g. usbCsvWrite, using buf as staging buffer. buf is
+// flushed when the next field does not fit and at csvEndLine. size must be at least CSV_FIELD_MAX.
+void csvInitWrite(CsvLine_t *csv, char *buf, size_t size, vformatWrite write, void *ctx);
+
+// As "%" PRId32
+void csvAppendInt(CsvLine_t *csv, int32_t value);
+
+// As "%.*f" with decimals in [0, CSV_MAX_DECIMALS], rounding the exact value of the float half to
+// even like printf. Values of 2^63 / 10^decimals or more are formatted by snprintf.
+void csvAppendFixed(CsvLine_t *csv, float value, int decimals);
+
+// As "0x%0*" PRIx32, digits is the minimum number of hex digits.
+void csvAppendHex(CsvLine_t *csv, uint32_t value, int digits);
+
+// Ends the line with CSV_LINE_END and flushes it to write if set.
+// Returns the length of the line, -1 if a field was dropped.
+int csvEndLine(CsvLine_t *csv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CSV_LINE_H_ */
@@ -0,0 +1,75 @@
+/*!
+** @file   outStream.h
+** @brief  Output stream interface, so formatted output can go to USB CDC, a W5500 TCP socket or a
+**         UART through the same functions. A fan-out stream passes everything written to it on to
+**         several streams, so a line formatted once is sent on all of them.
+** @date   16/10/2026
+*/
+
+#ifndef OUT_STREAM_H_
+#define OUT_STREAM_H_
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+/***************************************************************************************************
+** DEFINES
+***************************************************************************************************/
+
+#define OUT_FANOUT_MAX 4    // Streams of a fan-out
+
+/***************************************************************************************************
+** PUBLIC TYPES
+***************************************************************************************************/
+
+// A transport. Backends fill in the functions, e.g. usbOutStreamInit, W5500OutStreamInit and
+// uartOutStreamInit, ctx is passed to them.
+typedef struct {
+    ssize_t (*write)(void *ctx, const uint8_t *buf, size_t len);   // Returns the bytes accepted, < 0 on error
+    size_t (*available)(void *ctx);                                 // Bytes a write accepts without cutting
+    int (*flush)(void *ctx);                                        // Starts sending buffered data, 0 on success
+    void *ctx;
+} OutStream_t;
+
+typedef struct {
+    OutStream_t *streams[OUT_FANOUT_MAX];
+    int noOfStreams;
+} OutFanout_t;
+
+/***************************************************************************************************
+** PUBLIC FUNCTION DECLARATIONS
+***************************************************************************************************/
+
+ssize_t outWrite(OutStream_t *stream, const void *buf, size_t len);
+size_t outAvailable(OutStream_t *stream);
+int outFlush(OutStream_t *stream);
+
+// Formats as vsnprintf in a single pass, the output is written to the stream in pieces.
+// Returns the bytes the stream accepted, less than the formatted length if it cut the output, -1
+// if the format is invalid or a write failed.
+int outPrintf(OutStream_t *stream, const char *format, ...);
+int outVprintf(OutStream_t *stream, const char *format, va_list args);
+
+// vformatWrite with ctx an OutStream_t, e.g. for csvInitWrite. vformatWrite has no result, so
+// cut or failed writes are not reported, check outAvailable before the line if it matters.
+void outStreamWrite(void *ctx, const char *data, size_t len);
+
+// Makes stream write to all streams added to fanout. A write goes to all of them and returns the
+// first error, else the least number of bytes accepted by any of them. available is the least
+// available, flush fails if any flush failed.
+void outFanoutInit(OutStream_t *stream, OutFanout_t *fanout);
+
+// Returns 0 on success, -1 if the fan-out is full
+int outFanoutAdd(OutFanout_t *fanout, OutStream_t *target);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OUT_STREAM_H_ */
@@ -0,0 +1,47 @@
+/*!
+** @file   uartStream.h
+** @brief  Output stream backend for a UART, see outStream.h
+** @date   16/10/2026
+*/
+
+#ifndef UART_STREAM_H_
+#define UART_STREAM_H_
+
+#ifndef UNIT_TESTING
+  #if defined(STM32F401xC)
+    #include "stm32f4xx_hal.h"
+  #elif defined(STM32H753xx)
+    #include "stm32h7xx_hal.h"
+  #endif
+#else
+  #include "fake_stm32xxxx_hal.h"
+#endif
+
+#include "outStream.h"
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+/***************************************************************************************************
+** DEFINES
+***************************************************************************************************/
+
+#define UART_STREAM_TIMEOUT_MS 100  // Margin on the time a transmit takes at the UART baud rate
+
+/***************************************************************************************************
+** PUBLIC FUNCTION DECLARATIONS
+***************************************************************************************************/
+
+// Makes stream an output stream to huart. Writes are blocking (HAL_UART_Transmit), so nothing is
+// buffered, available is unlimited and flush does nothing. A write is sent in chunks of at most
+// 64 kB, each with a timeout of its transmit time at huart->Init.BaudRate plus
+// UART_STREAM_TIMEOUT_MS. It returns the bytes of the chunks sent before one failed, -1 if the
+// first failed.
+void uartOutStreamInit(UART_HandleTypeDef *huart, OutStream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UART_STREAM_H_ */
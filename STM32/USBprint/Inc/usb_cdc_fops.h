@@ -17,6 +17,7 @@
 #ifndef USB_CDC_FOPS_H
 #define USB_CDC_FOPS_H
 
+#include <stdarg.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <unistd.h>
@@ -31,12 +32,34 @@
 ** DEFINES
 ***************************************************************************************************/
 
-#define CIRCULAR_BUFFER_SIZE 1024
+#define CIRCULAR_BUFFER_SIZE 1024  // Power of two, the receive buffer is an spsc_ring_t
+#define CDC_TX_TRANSFER_SIZE (CIRCULAR_BUFFER_SIZE / 2)  // Max IN transfer from the transmit ring, multiple of 64
+
+#define CDC_RX_LINE_QUEUE 16  // Power of two, received lines not yet read by usb_cdc_rx_line
 
 #define CDC_ERROR_NONE              0x00000000U
 #define CDC_ERROR_DELAYED_TRANSMIT  0x00000001U
 #define CDC_ERROR_TRANSMIT          0x00000002U
 #define CDC_ERROR_CROPPED_TRANSMIT  0x00000004U
+#define CDC_ERROR_TX_FULL           0x00000008U  // All-or-nothing write rejected, see usb_cdc_tx_flow_control
+
+/***************************************************************************************************
+** PUBLIC TYPES
+***************************************************************************************************/
+
+typedef struct {
+    uint32_t transfers; // IN transfers started
+    uint32_t packets;   // USB packets of the transfers, including terminating zero length packets
+    uint32_t bytes;     // Bytes of the transfers
+    uint32_t queued;    // Bytes accepted by writes
+    uint32_t dropped;   // Bytes not sent as the transmit buffers were full
+    uint32_t retries;   // Transfers that failed to start, the data is kept and retried
+    uint32_t peakFill;  // Highest fill of the transmit ring in bytes
+} usb_cdc_tx_stats_t;
+
+// Called with high = true when the transmit ring fill reaches the high watermark, with
+// high = false when it has fallen to the low watermark.
+typedef void (*usb_cdc_watermark_t)(bool high);
 
 /***************************************************************************************************
 ** PUBLIC OBJECT DECLARATION
@@ -49,12 +72,43 @@ extern USBD_CDC_ItfTypeDef usb_cdc_fops;
 ***************************************************************************************************/
 
 ssize_t usb_cdc_transmit(const uint8_t* Buf, uint16_t len);
+
+// Formats as vsnprintf directly into the transmit buffers, without a line buffer or length limit.
+// Returns the number of bytes accepted, less than the formatted length if the buffers are full.
+// The output is written in pieces as it is formatted, so writes (usb_cdc_vprintf and
+// usb_cdc_transmit) must come from one context, e.g. the main loop. Without all-or-nothing the
+// pieces of writes from two contexts, e.g. an interrupt printing during a main loop print,
+// interleave in the ring. With all-or-nothing they would overwrite each other's staged output.
+int usb_cdc_vprintf(const char *format, va_list args);
 size_t usb_cdc_tx_available();
 int usb_cdc_rx(uint8_t* buf);
+
+// Copies the next complete received line, without its \r or \n terminator, into line and NUL
+// terminates it. Lines are found as packets arrive, so this does not scan byte by byte. A line longer
+// than size - 1 is cut. Returns the line length, 0 if no complete line is waiting, -1 on error
+// or if size < 2.
+int usb_cdc_rx_line(uint8_t* line, size_t size);
 void usb_cdc_rx_flush();
 bool isComPortOpen();
 uint32_t isCdcError();
 
+// Coalescing of small writes. With timeoutUs != 0 usb_cdc_transmit only queues the data in the
+// transmit ring. It is sent when a packet is full, on usb_cdc_tx_flush or when the oldest byte has
+// waited timeoutUs, checked on the next write or usb_cdc_tx_poll. 0 turns coalescing off (default).
+void usb_cdc_tx_coalesce(uint32_t timeoutUs);
+int usb_cdc_tx_flush();
+void usb_cdc_tx_poll();
+void usb_cdc_tx_stats(usb_cdc_tx_stats_t *stats);
+
+// Flow control. With allOrNothing a write that does not fit completely is rejected, returns 0 and
+// sets CDC_ERROR_TX_FULL, instead of being cut. The watermark function is called from writes and
+// usb_cdc_tx_poll (not from the interrupt), so producers can throttle before data is lost.
+// highWatermark = 0 turns the watermarks off. Default is no flow control.
+void usb_cdc_tx_flow_control(bool allOrNothing, size_t lowWatermark, size_t highWatermark,
+                             usb_cdc_watermark_t watermark);
+bool usb_cdc_tx_throttled();
+void usb_cdc_tx_stats_reset();
+
 #ifdef __cplusplus
 }
 #endif
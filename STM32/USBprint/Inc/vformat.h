@@ -0,0 +1,45 @@
+/*!
+** @file   vformat.h
+** @brief  printf style formatting streamed through a write function, so the output can go
+**         straight into its destination without an intermediate line buffer.
+** @date   15/10/2026
+*/
+
+#ifndef VFORMAT_H_
+#define VFORMAT_H_
+
+#include <stdarg.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+/***************************************************************************************************
+** DEFINES
+***************************************************************************************************/
+
+// Longest output of a single numeric conversion without its field width, e.g. %f or %.8x. The
+// width is padded separately, so %100d is fine. vformat fails on longer output, e.g. %.70f or
+// %f of 1e100, instead of cutting it.
+#define VFORMAT_NUMBER_MAX 64
+
+/***************************************************************************************************
+** PUBLIC FUNCTION DECLARATIONS
+***************************************************************************************************/
+
+// Receives the formatted output in pieces, in order. Literal text and %s arguments are passed
+// directly from the format string/argument.
+typedef void (*vformatWrite)(void *ctx, const char *data, size_t len);
+
+// Format as vsnprintf, passing the output to write. There is no limit on the total length.
+// %n, %ls and %lc are not supported.
+// @Return Length of the formatted output, -1 if the format is invalid or unsupported. Output before
+//         the failing conversion has already been written.
+int vformat(vformatWrite write, void *ctx, const char *format, va_list args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VFORMAT_H_ */
@@ -13,16 +13,17 @@
 #include "usb_cdc_fops.h"
 
 int USBnprintf(const char* format, ...) {
-    static char buffer[256];
-    int len = 0;
-
     va_list args;
     va_start(args, format);
-    len += vsnprintf(&buffer[len], sizeof(buffer) - len, format, args);
+    int len = USBvprintf(format, args);
     va_end(args);
 
-    /* Error code captured in lower level module */
-    return usb_cdc_transmit((const uint8_t*)buffer, len);
+    return len;
+}
+
+int USBvprintf(const char* format, va_list args) {
+    /* Formatted straight into the transmit buffers. Error code captured in lower level module */
+    return usb_cdc_vprintf(format, args);
 }
 
 ssize_t writeUSB(const void* buf, size_t count) {
@@ -30,6 +31,20 @@ ssize_t writeUSB(const void* buf, size_t count) {
     return usb_cdc_transmit((const uint8_t*)buf, count);
 }
 
+void usbCsvWrite(void *ctx, const char *data, size_t len) {
+    writeUSB(data, len);
+}
+
+ssize_t usbStreamAdc(const BStreamHeader_t *hdr, const int16_t *pBuffer, int noOfChannels, const float *scale) {
+    static uint8_t frame[CIRCULAR_BUFFER_SIZE];
+
+    size_t len = bstreamEncode(frame, sizeof(frame), hdr, pBuffer, noOfChannels, scale);
+    if (len == 0) {
+        return -1;
+    }
+    return writeUSB(frame, len);
+}
+
 size_t txAvailable() {
     return usb_cdc_tx_available();
 }
@@ -48,6 +63,13 @@ int usbRx(uint8_t* buf) {
     return usb_cdc_rx(buf);
 }
 
+/*!
+** @brief Function to get the next complete line from the USB receive buffer
+*/
+int usbRxLine(uint8_t* buf, size_t size) {
+    return usb_cdc_rx_line(buf, size);
+}
+
 /*!
 ** @brief Function to flush USB buffers
 */
@@ -55,9 +77,84 @@ void usbFlush() {
     usb_cdc_rx_flush();
 }
 
+/*!
+** @brief Sets the coalescing timeout of small writes, 0 to send every write at once
+*/
+void usbTxCoalesce(uint32_t timeoutUs) {
+    usb_cdc_tx_coalesce(timeoutUs);
+}
+
+/*!
+** @brief Sends the data gathered by coalescing
+*/
+int usbTxFlush() {
+    return usb_cdc_tx_flush();
+}
+
+/*!
+** @brief Sends the data gathered by coalescing once it has timed out
+*/
+void usbTxPoll() {
+    usb_cdc_tx_poll();
+}
+
+/*!
+** @brief Sets all-or-nothing writes and the transmit buffer watermarks
+*/
+void usbTxFlowControl(bool allOrNothing, size_t lowWatermark, size_t highWatermark, void (*watermark)(bool high)) {
+    usb_cdc_tx_flow_control(allOrNothing, lowWatermark, highWatermark, watermark);
+}
+
+/*!
+** @brief Returns true while the transmit buffer fill is above the watermarks
+*/
+bool usbTxThrottled() {
+    return usb_cdc_tx_throttled();
+}
+
+/*!
+** @brief Returns the counters of the transmit path
+*/
+void usbTxCounters(UsbTxCounters *counters) {
+    usb_cdc_tx_stats_t stats;
+    usb_cdc_tx_stats(&stats);
+    counters->queued   = stats.queued;
+    counters->sent     = stats.bytes;
+    counters->dropped  = stats.dropped;
+    counters->packets  = stats.packets;
+    counters->retries  = stats.retries;
+    counters->peakFill = stats.peakFill;
+}
+
+void usbTxCountersReset() {
+    usb_cdc_tx_stats_reset();
+}
+
 /*!
 ** @brief Returns if there has been an error in the USB stack
 */
 uint32_t isUsbError() {
     return isCdcError();
-}
\ No newline at end of file
+}
+
+static ssize_t usbStreamWrite(void *ctx, const uint8_t *buf, size_t len) {
+    return writeUSB(buf, len);
+}
+
+static size_t usbStreamAvailable(void *ctx) {
+    return txAvailable();
+}
+
+static int usbStreamFlush(void *ctx) {
+    return usbTxFlush();
+}
+
+/*!
+** @brief Makes stream an output stream to the USB port
+*/
+void usbOutStreamInit(OutStream_t *stream) {
+    stream->write = usbStreamWrite;
+    stream->available = usbStreamAvailable;
+    stream->flush = usbStreamFlush;
+    stream->ctx = NULL;
+}
@@ -0,0 +1,252 @@
+/*!
+** @file   binaryStream.c
+** @brief  Binary framed streaming of ADC samples. The frame is COBS encoded while it is built, so
+**         neither the raw frame nor the samples are staged in a separate buffer. The CRC is
+**         updated per sample row along the way.
+** @date   15/10/2026
+*/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "binaryStream.h"
+#include "crc.h"
+
+/***************************************************************************************************
+** PRIVATE TYPES
+***************************************************************************************************/
+
+// COBS encoder writing straight into the frame buffer
+typedef struct {
+    uint8_t *dst;
+    size_t pos;     // Next free byte of dst
+    size_t code;    // Position of the code byte of the current block
+    uint16_t crc;   // Of the bytes passed to putField
+} cobsWriter_t;
+
+/***************************************************************************************************
+** PRIVATE FUNCTION DEFINITIONS
+***************************************************************************************************/
+
+static void cobsStart(cobsWriter_t *w, uint8_t *dst)
+{
+    w->dst = dst;
+    w->code = 0;
+    w->pos = 1;
+    w->crc = CRC16_INIT;
+}
+
+static void cobsPut(cobsWriter_t *w, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        if (data[i] == 0)
+        {
+            w->dst[w->code] = (uint8_t) (w->pos - w->code);
+            w->code = w->pos++;
+            continue;
+        }
+
+        w->dst[w->pos++] = data[i];
+        if (w->pos - w->code == 0xFF)
+        {
+            // Longest block, 254 bytes without a zero
+            w->dst[w->code] = 0xFF;
+            w->code = w->pos++;
+        }
+    }
+}
+
+/*!
+** @brief Returns the encoded length, without a 0 delimiter
+*/
+static size_t cobsEnd(cobsWriter_t *w)
+{
+    w->dst[w->code] = (uint8_t) (w->pos - w->code);
+    return w->pos;
+}
+
+static void putField(cobsWriter_t *w, const uint8_t *data, size_t len)
+{
+    w->crc = crc16Calculate(w->crc, data, len);
+    cobsPut(w, data, len);
+}
+
+static void putLE(uint8_t *dst, uint64_t value, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        dst[i] = (uint8_t) (value >> (8 * i));
+    }
+}
+
+static uint64_t getLE(const uint8_t *src, size_t len)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        value |= (uint64_t) src[i] << (8 * i);
+    }
+    return value;
+}
+
+static size_t sampleSize(uint8_t format)
+{
+    return (format == BSTREAM_INT16) ? sizeof(int16_t) : (format == BSTREAM_FLOAT32) ? sizeof(float) : 0;
+}
+
+/***************************************************************************************************
+** PUBLIC FUNCTION DEFINITIONS
+***************************************************************************************************/
+
+size_t bstreamEncode(uint8_t *dst, size_t size, const BStreamHeader_t *hdr, const int16_t *pBuffer,
+                     int noOfChannels, const float *scale)
+{
+    if (!dst || !hdr || !pBuffer || noOfChannels <= 0 || hdr->channelMask == 0 ||
+        sampleSize(hdr->format) == 0 || (hdr->format == BSTREAM_FLOAT32 && !scale) ||
+        (noOfChannels < 32 && (hdr->channelMask >> noOfChannels) != 0))
+    {
+        return 0;
+    }
+
+    // Channels of the frame, in order
+    uint8_t channels[32];
+    size_t noOfFrameChannels = 0;
+    for (int ch = 0; ch < noOfChannels && ch < 32; ch++)
+    {
+        if (hdr->channelMask & (1UL << ch))
+            channels[noOfFrameChannels++] = (uint8_t) ch;
+    }
+
+    size_t rowLen = noOfFrameChannels * sampleSize(hdr->format);
+    if (BSTREAM_FRAME_SIZE(rowLen * hdr->noOfSamples) > size)
+    {
+        return 0;
+    }
+
+    uint8_t header[BSTREAM_HEADER_SIZE];
+    header[0] = BSTREAM_VERSION;
+    header[1] = hdr->format;
+    putLE(&header[2], hdr->noOfSamples, 2);
+    putLE(&header[4], hdr->sequence, 4);
+    putLE(&header[8], hdr->timestamp, 8);
+    putLE(&header[16], hdr->channelMask, 4);
+
+    cobsWriter_t w;
+    cobsStart(&w, dst);
+    putField(&w, header, sizeof(header));
+
+    uint8_t row[32 * sizeof(float)];
+    for (uint16_t s = 0; s < hdr->noOfSamples; s++)
+    {
+        const int16_t *pSample = &pBuffer[s * noOfChannels];
+        for (size_t i = 0; i < noOfFrameChannels; i++)
+        {
+            int ch = channels[i];
+            if (hdr->format == BSTREAM_INT16)
+            {
+                putLE(&row[i * sizeof(int16_t)], (uint16_t) pSample[ch], sizeof(int16_t));
+            }
+            else
+            {
+                float value = pSample[ch] * scale[ch];
+                uint32_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                putLE(&row[i * sizeof(float)], bits, sizeof(float));
+            }
+        }
+        putField(&w, row, rowLen);
+    }
+
+    uint8_t crc[BSTREAM_CRC_SIZE];
+    putLE(crc, w.crc, sizeof(crc));
+    cobsPut(&w, crc, sizeof(crc));
+
+    size_t len = cobsEnd(&w);
+    dst[len++] = 0;
+    return len;
+}
+
+int bstreamDecode(uint8_t *frame, size_t len, BStreamHeader_t *hdr, float *samples, size_t maxSamples)
+{
+    int decoded = cobsDecode(frame, len, frame);
+    if (!hdr || decoded < BSTREAM_HEADER_SIZE + BSTREAM_CRC_SIZE)
+    {
+        return -1;
+    }
+
+    size_t dataLen = decoded - BSTREAM_CRC_SIZE;
+    if (crc16Calculate(CRC16_INIT, frame, dataLen) != getLE(&frame[dataLen], BSTREAM_CRC_SIZE) ||
+        frame[0] != BSTREAM_VERSION)
+    {
+        return -1;
+    }
+
+    hdr->format = frame[1];
+    hdr->noOfSamples = (uint16_t) getLE(&frame[2], 2);
+    hdr->sequence = (uint32_t) getLE(&frame[4], 4);
+    hdr->timestamp = getLE(&frame[8], 8);
+    hdr->channelMask = (uint32_t) getLE(&frame[16], 4);
+
+    size_t size = sampleSize(hdr->format);
+    size_t count = (size_t) __builtin_popcount(hdr->channelMask) * hdr->noOfSamples;
+    if (size == 0 || BSTREAM_HEADER_SIZE + count * size != dataLen || count > maxSamples ||
+        (count != 0 && !samples))
+    {
+        return -1;
+    }
+
+    const uint8_t *src = &frame[BSTREAM_HEADER_SIZE];
+    for (size_t i = 0; i < count; i++, src += size)
+    {
+        if (hdr->format == BSTREAM_INT16)
+        {
+            samples[i] = (int16_t) getLE(src, size);
+        }
+        else
+        {
+            uint32_t bits = (uint32_t) getLE(src, size);
+            memcpy(&samples[i], &bits, sizeof(float));
+        }
+    }
+    return (int) count;
+}
+
+size_t cobsEncode(const uint8_t *src, size_t len, uint8_t *dst)
+{
+    cobsWriter_t w;
+    cobsStart(&w, dst);
+    cobsPut(&w, src, len);
+    return cobsEnd(&w);
+}
+
+int cobsDecode(const uint8_t *src, size_t len, uint8_t *dst)
+{
+    size_t in = 0;
+    size_t out = 0;
+
+    // The output never overtakes the input, so decoding in place is safe
+    while (in < len)
+    {
+        uint8_t code = src[in++];
+        if (code == 0 || in + code - 1 > len)
+        {
+            return -1;
+        }
+
+        for (uint8_t i = 1; i < code; i++)
+        {
+            if (src[in] == 0)
+            {
+                return -1;
+            }
+            dst[out++] = src[in++];
+        }
+
+        if (code != 0xFF && in < len)
+        {
+            dst[out++] = 0;
+        }
+    }
+    return (int) out;
+}
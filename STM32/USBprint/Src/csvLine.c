@@ -0,0 +1,250 @@
+/*!
+** @file   csvLine.c
+** @brief  Builder of comma separated data lines without printf. A float is split in its integer
+**         mantissa and exponent, so value * 10^decimals is computed exactly in 64 bit integers
+**         and rounded as printf does, without double precision or libc conversions.
+** @date   15/10/2026
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "csvLine.h"
+
+/***************************************************************************************************
+** PRIVATE OBJECTS
+***************************************************************************************************/
+
+static const uint32_t powersOf10[CSV_MAX_DECIMALS + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+static const uint32_t powersOf5[CSV_MAX_DECIMALS + 1] = {
+    1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125
+};
+
+/***************************************************************************************************
+** PRIVATE FUNCTION DEFINITIONS
+***************************************************************************************************/
+
+/*!
+** @brief Writes the decimal digits of value ending just before end, returns the first digit
+*/
+static char* putDecimal(char *end, uint64_t value)
+{
+    // 32 bit divisions as long as possible, 64 bit division is a library call on Cortex-M
+    while (value > UINT32_MAX)
+    {
+        *--end = (char) ('0' + value % 10);
+        value /= 10;
+    }
+
+    uint32_t value32 = (uint32_t) value;
+    do
+    {
+        *--end = (char) ('0' + value32 % 10);
+        value32 /= 10;
+    } while (value32 != 0);
+
+    return end;
+}
+
+/*!
+** @brief Appends field, preceded by the separator unless it is the first field of the line
+*/
+static void appendField(CsvLine_t *csv, const char *field, size_t len)
+{
+    const size_t sepLen = (csv->total != 0) ? sizeof(CSV_SEPARATOR) - 1 : 0;
+
+    if (csv->len + sepLen + len >= csv->size && csv->write)
+    {
+        csv->write(csv->ctx, csv->buf, csv->len);
+        csv->len = 0;
+    }
+    if (csv->len + sepLen + len >= csv->size)
+    {
+        csv->overflow = true;
+        return;
+    }
+
+    memcpy(&csv->buf[csv->len], CSV_SEPARATOR, sepLen);
+    memcpy(&csv->buf[csv->len + sepLen], field, len);
+    csv->len += sepLen + len;
+    csv->total += sepLen + len;
+    csv->buf[csv->len] = '\0';
+}
+
+/***************************************************************************************************
+** PUBLIC FUNCTION DEFINITIONS
+***************************************************************************************************/
+
+void csvInit(CsvLine_t *csv, char *buf, size_t size)
+{
+    csvInitWrite(csv, buf, size, NULL, NULL);
+}
+
+void csvInitWrite(CsvLine_t *csv, char *buf, size_t size, vformatWrite write, void *ctx)
+{
+    csv->buf = buf;
+    csv->size = size;
+    csv->len = 0;
+    csv->total = 0;
+    csv->overflow = (size == 0);
+    csv->write = write;
+    csv->ctx = ctx;
+    if (size != 0)
+    {
+        buf[0] = '\0';
+    }
+}
+
+void csvAppendInt(CsvLine_t *csv, int32_t value)
+{
+    char field[12];
+    char *end = &field[sizeof(field)];
+
+    // Magnitude as unsigned, so INT32_MIN does not overflow
+    uint32_t magnitude = (value < 0) ? 0U - (uint32_t) value : (uint32_t) value;
+    char *start = putDecimal(end, magnitude);
+    if (value < 0)
+    {
+        *--start = '-';
+    }
+    appendField(csv, start, end - start);
+}
+
+void csvAppendFixed(CsvLine_t *csv, float value, int decimals)
+{
+    char field[CSV_FIELD_MAX];
+
+    if (decimals < 0)
+        decimals = 0;
+    if (decimals > CSV_MAX_DECIMALS)
+        decimals = CSV_MAX_DECIMALS;
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const bool negative = (bits >> 31) != 0;
+    const int biasedExp = (bits >> 23) & 0xFF;
+    const uint32_t fraction = bits & 0x7FFFFF;
+
+    if (biasedExp == 0xFF)
+    {
+        const char *text = (fraction != 0) ? "nan" : (negative ? "-inf" : "inf");
+        appendField(csv, text, strlen(text));
+        return;
+    }
+
+    // value = mantissa * 2^exponent, so value * 10^d = mantissa * 5^d * 2^(exponent + d).
+    // mantissa * 5^d has at most 24 + 21 bits.
+    const uint64_t mantissa = (biasedExp == 0) ? fraction : (fraction | 0x800000);
+    const int shift = ((biasedExp == 0) ? -149 : biasedExp - 150) + decimals;
+    const uint64_t exact = mantissa * powersOf5[decimals];
+
+    uint64_t scaled;
+    if (shift >= 0)
+    {
+        if (exact != 0 && (shift >= 64 || (exact >> (63 - shift)) != 0))
+        {
+            // 2^63 or more, rare enough for measurements to leave to snprintf
+            int len = snprintf(field, sizeof(field), "%.*f", decimals, (double) value);
+            appendField(csv, field, (len < (int) sizeof(field)) ? len : sizeof(field) - 1);
+            return;
+        }
+        scaled = exact << shift;
+    }
+    else if (-shift >= 64)
+    {
+        scaled = 0; // Less than 2^53 / 2^64, rounds to 0
+    }
+    else
+    {
+        // Round half to even on the exact remainder
+        const int right = -shift;
+        const uint64_t remainder = exact & ((1ULL << right) - 1);
+        const uint64_t half = 1ULL << (right - 1);
+        scaled = exact >> right;
+        if (remainder > half || (remainder == half && (scaled & 1)))
+        {
+            scaled++;
+        }
+    }
+
+    char *end = &field[sizeof(field)];
+    char *start = end;
+    uint64_t integer = scaled;
+    if (decimals > 0)
+    {
+        uint32_t frac;
+        if (scaled <= UINT32_MAX)
+        {
+            frac = (uint32_t) scaled % powersOf10[decimals];
+            integer = (uint32_t) scaled / powersOf10[decimals];
+        }
+        else
+        {
+            frac = (uint32_t) (scaled % powersOf10[decimals]);
+            integer = scaled / powersOf10[decimals];
+        }
+        for (int i = 0; i < decimals; i++)
+        {
+            *--start = (char) ('0' + frac % 10);
+            frac /= 10;
+        }
+        *--start = '.';
+    }
+    start = putDecimal(start, integer);
+    if (negative)
+    {
+        *--start = '-';
+    }
+    appendField(csv, start, end - start);
+}
+
+void csvAppendHex(CsvLine_t *csv, uint32_t value, int digits)
+{
+    static const char hex[] = "0123456789abcdef";
+    char field[2 + 16];
+    char *end = &field[sizeof(field)];
+    char *start = end;
+
+    if (digits > 16)
+        digits = 16;
+    do
+    {
+        *--start = hex[value & 0xF];
+        value >>= 4;
+        digits--;
+    } while (value != 0 || digits > 0);
+
+    *--start = 'x';
+    *--start = '0';
+    appendField(csv, start, end - start);
+}
+
+int csvEndLine(CsvLine_t *csv)
+{
+    const size_t endLen = sizeof(CSV_LINE_END) - 1;
+
+    if (csv->len + endLen >= csv->size && csv->write)
+    {
+        csv->write(csv->ctx, csv->buf, csv->len);
+        csv->len = 0;
+    }
+    if (csv->len + endLen >= csv->size)
+    {
+        csv->overflow = true;
+    }
+    else
+    {
+        memcpy(&csv->buf[csv->len], CSV_LINE_END, endLen + 1);
+        csv->len += endLen;
+        csv->total += endLen;
+    }
+
+    if (csv->write && csv->len != 0)
+    {
+        csv->write(csv->ctx, csv->buf, csv->len);
+        csv->len = 0;
+    }
+    return csv->overflow ? -1 : (int) csv->total;
+}
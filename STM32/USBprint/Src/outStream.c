@@ -0,0 +1,152 @@
+/*!
+** @file   outStream.c
+** @brief  Output stream interface and fan-out. Formatting is done once by vformat and each piece
+**         is written to the stream, for a fan-out to every stream of it.
+** @date   16/10/2026
+*/
+
+#include <stdbool.h>
+
+#include "outStream.h"
+#include "vformat.h"
+
+/***************************************************************************************************
+** PRIVATE TYPES
+***************************************************************************************************/
+
+// Output of outVprintf
+typedef struct {
+    OutStream_t *stream;
+    ssize_t accepted;   // Bytes accepted by the stream, < 0 after the first error
+} outSink_t;
+
+/***************************************************************************************************
+** PRIVATE FUNCTION DEFINITIONS
+***************************************************************************************************/
+
+static ssize_t fanoutWrite(void *ctx, const uint8_t *buf, size_t len)
+{
+    OutFanout_t *fanout = (OutFanout_t*) ctx;
+    ssize_t accepted = (ssize_t) len;
+
+    // Every stream gets the data, the result is the first error or else the least accepted
+    for (int i = 0; i < fanout->noOfStreams; i++)
+    {
+        ssize_t written = outWrite(fanout->streams[i], buf, len);
+        if (accepted >= 0 && written < accepted)
+            accepted = written;
+    }
+    return accepted;
+}
+
+static size_t fanoutAvailable(void *ctx)
+{
+    OutFanout_t *fanout = (OutFanout_t*) ctx;
+    size_t available = SIZE_MAX;
+
+    for (int i = 0; i < fanout->noOfStreams; i++)
+    {
+        size_t streamAvailable = outAvailable(fanout->streams[i]);
+        if (streamAvailable < available)
+            available = streamAvailable;
+    }
+    return (fanout->noOfStreams != 0) ? available : 0;
+}
+
+static int fanoutFlush(void *ctx)
+{
+    OutFanout_t *fanout = (OutFanout_t*) ctx;
+    int ret = 0;
+
+    for (int i = 0; i < fanout->noOfStreams; i++)
+    {
+        if (outFlush(fanout->streams[i]) != 0)
+            ret = -1;
+    }
+    return ret;
+}
+
+/*!
+** @brief vformat output of outVprintf, keeps the first error of the stream
+*/
+static void sinkWrite(void *ctx, const char *data, size_t len)
+{
+    outSink_t *sink = (outSink_t*) ctx;
+    ssize_t written = outWrite(sink->stream, data, len);
+
+    if (sink->accepted >= 0)
+        sink->accepted = (written < 0) ? written : sink->accepted + written;
+}
+
+/***************************************************************************************************
+** PUBLIC FUNCTION DEFINITIONS
+***************************************************************************************************/
+
+ssize_t outWrite(OutStream_t *stream, const void *buf, size_t len)
+{
+    if (!stream || !stream->write)
+        return -1;
+
+    return stream->write(stream->ctx, (const uint8_t*) buf, len);
+}
+
+size_t outAvailable(OutStream_t *stream)
+{
+    if (!stream || !stream->available)
+        return 0;
+
+    return stream->available(stream->ctx);
+}
+
+int outFlush(OutStream_t *stream)
+{
+    if (!stream)
+        return -1;
+
+    // Nothing to flush for unbuffered transports
+    return stream->flush ? stream->flush(stream->ctx) : 0;
+}
+
+int outPrintf(OutStream_t *stream, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int len = outVprintf(stream, format, args);
+    va_end(args);
+
+    return len;
+}
+
+int outVprintf(OutStream_t *stream, const char *format, va_list args)
+{
+    outSink_t sink = { stream, 0 };
+
+    int len = vformat(sinkWrite, &sink, format, args);
+    if (len < 0 || sink.accepted < 0)
+        return -1;
+
+    return (int) sink.accepted;
+}
+
+void outStreamWrite(void *ctx, const char *data, size_t len)
+{
+    outWrite((OutStream_t*) ctx, data, len);
+}
+
+void outFanoutInit(OutStream_t *stream, OutFanout_t *fanout)
+{
+    fanout->noOfStreams = 0;
+    stream->write = fanoutWrite;
+    stream->available = fanoutAvailable;
+    stream->flush = fanoutFlush;
+    stream->ctx = fanout;
+}
+
+int outFanoutAdd(OutFanout_t *fanout, OutStream_t *target)
+{
+    if (!target || fanout->noOfStreams >= OUT_FANOUT_MAX)
+        return -1;
+
+    fanout->streams[fanout->noOfStreams++] = target;
+    return 0;
+}
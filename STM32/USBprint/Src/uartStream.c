@@ -0,0 +1,59 @@
+/*!
+** @file   uartStream.c
+** @brief  Output stream backend for a UART using blocking HAL transmits
+** @date   16/10/2026
+*/
+
+#include "uartStream.h"
+
+/***************************************************************************************************
+** PRIVATE FUNCTION DEFINITIONS
+***************************************************************************************************/
+
+/*!
+** @brief Timeout of a HAL_UART_Transmit of len bytes, the time it takes plus a margin
+** @note  12 bit times per byte covers start, 8 data, parity and 2 stop bits
+*/
+static uint32_t transmitTimeout(const UART_HandleTypeDef *huart, uint16_t len)
+{
+    uint32_t baudRate = huart->Init.BaudRate;
+    uint32_t bits = (uint32_t) len * 12;
+
+    if (baudRate == 0)
+        return UART_STREAM_TIMEOUT_MS;
+    return (uint32_t) (((uint64_t) bits * 1000 + baudRate - 1) / baudRate) + UART_STREAM_TIMEOUT_MS;
+}
+
+static ssize_t uartStreamWrite(void *ctx, const uint8_t *buf, size_t len)
+{
+    UART_HandleTypeDef *huart = (UART_HandleTypeDef*) ctx;
+    size_t written = 0;
+
+    while (written < len)
+    {
+        uint16_t chunk = (len - written > UINT16_MAX) ? UINT16_MAX : (uint16_t) (len - written);
+        if (HAL_UART_Transmit(huart, (uint8_t*) &buf[written], chunk, transmitTimeout(huart, chunk)) != HAL_OK)
+        {
+            return (written != 0) ? (ssize_t) written : -1;
+        }
+        written += chunk;
+    }
+    return (ssize_t) written;
+}
+
+static size_t uartStreamAvailable(void *ctx)
+{
+    return SIZE_MAX;
+}
+
+/***************************************************************************************************
+** PUBLIC FUNCTION DEFINITIONS
+***************************************************************************************************/
+
+void uartOutStreamInit(UART_HandleTypeDef *huart, OutStream_t *stream)
+{
+    stream->write = uartStreamWrite;
+    stream->available = uartStreamAvailable;
+    stream->flush = NULL;
+    stream->ctx = huart;
+}
@@ -6,6 +6,8 @@
 
 #include <assert.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
 
 #if defined(STM32F401xC)
   #include "stm32f4xx_hal.h"
@@ -15,6 +17,8 @@
 
 #include "usb_cdc_fops.h"
 #include "circular_buffer.h"
+#include "spsc_ring.h"
+#include "vformat.h"
 
 /***************************************************************************************************
 ** DEFINES
@@ -31,6 +35,18 @@ static int8_t CDC_DeInit_FS(void);
 static int8_t CDC_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length);
 static int8_t CDC_Receive_FS(uint8_t* pbuf, uint32_t *Len);
 static int8_t CDC_TransmitCplt_FS(uint8_t *pbuf, uint32_t *Len, uint8_t epnum);
+static uint8_t transmitFromRing();
+static size_t queueTx(const uint8_t* Buf, size_t Len);
+static void commitTx(size_t Len);
+static bool acceptWrite(bool direct, size_t Len);
+static uint8_t startQueued(bool *started);
+static void checkWatermarks();
+static void printWrite(void *ctx, const char *data, size_t len);
+static bool isCoalesceDue();
+static void countTransfer(size_t len);
+static void findLines(const uint8_t* Buf, size_t len, size_t start);
+static bool isLineEnd(uint8_t c);
+static void skipLineRest(spsc_ring_t *ring, size_t pending);
 
 /***************************************************************************************************
 ** PUBLIC OBJECTS
@@ -68,17 +84,45 @@ static struct
 {
     struct {
         cbuf_handle_t ctx;
+        uint8_t irqBuf[CIRCULAR_BUFFER_SIZE];   // Transfer started while idle, ctx stages the next ones
+        size_t inFlight;                        // Bytes of ctx being transmitted directly from the ring
+        uint32_t coalesceCycles;                // 0 if coalescing is off, else max cycles bytes wait in ctx
+        uint32_t queuedAt;                      // DWT->CYCCNT when the oldest unsent byte was queued
+        bool flushPending;                      // usb_cdc_tx_flush while busy, send the rest on completion
+        bool allOrNothing;                      // Reject writes that do not fit completely
+        size_t lowWatermark;                    // Fill of ctx that ends throttling
+        size_t highWatermark;                   // Fill of ctx that starts throttling, 0 if off
+        usb_cdc_watermark_t watermark;
+        bool throttled;
+        usb_cdc_tx_stats_t stats;
+    } tx;
+    struct {
+        spsc_ring_t *ctx;                       // Filled from the USB interrupt, emptied from the main loop
         uint8_t irqBuf[CIRCULAR_BUFFER_SIZE];   // lower layer buffer for IRQ USB_CDC driver callback
-    } tx, rx;
+        size_t lines[CDC_RX_LINE_QUEUE];        // Ring index just past each received line terminator
+        size_t lineHead;                        // Free running, written by the USB interrupt only
+        size_t lineTail;                        // Free running, written by the main loop only
+        size_t lineLen;                         // Bytes of the line being received
+    } rx;
     comport_t isComPortOpen;
     unsigned long portOpenTime;
 } usb_cdc_if = { {0}, {0}, closed, 0};
 
+// Output of usb_cdc_vprintf
+typedef struct {
+    bool direct;        // Endpoint was idle, format into tx.irqBuf. The rest goes to the ring.
+    bool stage;         // All-or-nothing, the ring part is staged and committed at the end
+    bool full;          // A staged piece did not fit, the output is dropped
+    size_t directLen;   // Bytes in tx.irqBuf
+    size_t staged;      // Bytes staged in the ring
+    size_t written;     // Bytes accepted in total
+} printSink_t;
+
 static volatile uint32_t usb_error = CDC_ERROR_NONE;
 
 static circular_buf_t   tx_cb;
 static uint8_t          tx_buf[CIRCULAR_BUFFER_SIZE] = {0};
-static circular_buf_t   rx_cb;
+static spsc_ring_t      rx_ring;
 static uint8_t          rx_buf[CIRCULAR_BUFFER_SIZE] = {0};
 
 
@@ -102,7 +146,7 @@ void usb_cdc_rx_flush()
     if (!usb_cdc_if.tx.ctx)
         return; // Error, USB CDC is not initialized
 
-    circular_buf_reset(usb_cdc_if.rx.ctx);
+    spsc_ring_flush(usb_cdc_if.rx.ctx);
 }
 
 int usb_cdc_rx(uint8_t* rxByte)
@@ -110,7 +154,57 @@ int usb_cdc_rx(uint8_t* rxByte)
     if (!usb_cdc_if.tx.ctx)
         return -1; // Error, USB CDC is not initialized
 
-    return circular_buf_get(usb_cdc_if.rx.ctx, rxByte);
+    return spsc_ring_get(usb_cdc_if.rx.ctx, rxByte);
+}
+
+int usb_cdc_rx_line(uint8_t* line, size_t size)
+{
+    if (!usb_cdc_if.tx.ctx || !line || size < 2)
+        return -1; // Error, USB CDC is not initialized or no room for a character
+
+    spsc_ring_t *ring = usb_cdc_if.rx.ctx;
+    size_t qTail = usb_cdc_if.rx.lineTail;
+    while (qTail != __atomic_load_n(&usb_cdc_if.rx.lineHead, __ATOMIC_ACQUIRE))
+    {
+        size_t pending = usb_cdc_if.rx.lines[qTail & (CDC_RX_LINE_QUEUE - 1)] - ring->tail;
+        if ((ptrdiff_t) pending <= 0)
+        {
+            // Line already read, by usb_cdc_rx, usb_cdc_rx_flush or a previous call
+            __atomic_store_n(&usb_cdc_if.rx.lineTail, ++qTail, __ATOMIC_RELEASE);
+            continue;
+        }
+
+        // Leading terminators end the previous line (\r\n). An entry can hold several lines if
+        // the queue was full, so the line ends at the first terminator after them.
+        size_t n = spsc_ring_peek(ring, line, (pending < size - 1) ? pending : size - 1);
+        size_t first = 0;
+        while (first < n && isLineEnd(line[first]))
+            first++;
+        size_t last = first;
+        while (last < n && !isLineEnd(line[last]))
+            last++;
+
+        if (first == n)
+        {
+            spsc_ring_skip(ring, n);
+            continue;
+        }
+        // Past the terminator. A line longer than size - 1 is cut and its end discarded, up to
+        // its own terminator only, the lines merged after it stay.
+        if (last < n) {
+            spsc_ring_skip(ring, last + 1);
+        }
+        else {
+            spsc_ring_skip(ring, n);
+            skipLineRest(ring, pending - n);
+        }
+
+        size_t len = last - first;
+        memmove(line, &line[first], len);
+        line[len] = '\0';
+        return (int) len;
+    }
+    return 0;
 }
 
 /**
@@ -143,48 +237,151 @@ ssize_t usb_cdc_transmit(const uint8_t* Buf, uint16_t Len)
     */
     HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
 
-    // USB CDC is transmitting data to the network. Leave transmit handling to CDC_TransmitCplt_FS
-    if (hcdc->TxState != 0) {
-        for (int len = 0; len < Len; len++) {
-            if (circular_buf_put(usb_cdc_if.tx.ctx, *Buf)) {
-                // len < Len since not enough space in buffer. Leave error handling to caller.
-                HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
-                return len;  
-            }
-            Buf++;
-        }
+    // Idle with nothing queued, send directly from tx.irqBuf. Else queue the data in the ring, it is
+    // sent by CDC_TransmitCplt_FS. With coalescing the ring gathers the data until a packet is full
+    // or it times out.
+    bool direct = usb_cdc_if.tx.coalesceCycles == 0 && hcdc->TxState == 0 &&
+                  circular_buf_empty(usb_cdc_if.tx.ctx);
+
+    if (!acceptWrite(direct, Len)) {
+        HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+        return 0; // All-or-nothing and there is no room
+    }
+
+    if (!direct) {
+        // Less than Len is written if there is not enough space in buffer. Leave error handling to caller.
+        bool started;
+        size_t len = queueTx(Buf, Len);
+        uint8_t result = startQueued(&started);
         HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
 
-        return Len;
+        if (result != USBD_OK)
+            usb_error |= CDC_ERROR_TRANSMIT; // Kept in the ring and retried
+        checkWatermarks();
+
+        return len;
     }
 
     HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
 
     // Fill in the data from buffer directly, no need copy bytes
+    size_t rest = 0;
     if (Len > sizeof(usb_cdc_if.tx.irqBuf))
     {
-        // remaining bytes could be moved to circular buffer but in this case,
-        // system is possible in a lack of resources. That problem can not be solved hear.
+        if (usb_cdc_if.tx.allOrNothing) {
+            // acceptWrite made sure the rest fits in the ring, it follows when this transfer completes
+            rest = Len - sizeof(usb_cdc_if.tx.irqBuf);
+            HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
+            queueTx(&Buf[sizeof(usb_cdc_if.tx.irqBuf)], rest);
+            HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+        }
+        else {
+            // remaining bytes could be moved to circular buffer but in this case,
+            // system is possible in a lack of resources. That problem can not be solved hear.
+            usb_cdc_if.tx.stats.dropped += Len - sizeof(usb_cdc_if.tx.irqBuf);
+            usb_error |= CDC_ERROR_CROPPED_TRANSMIT;
+        }
         Len = sizeof(usb_cdc_if.tx.irqBuf);
-        usb_error |= CDC_ERROR_CROPPED_TRANSMIT;
     }
     else {
         usb_error &= ~CDC_ERROR_CROPPED_TRANSMIT;
     }
 
     memcpy(usb_cdc_if.tx.irqBuf, Buf, Len);
+    usb_cdc_if.tx.inFlight = 0;
+    usb_cdc_if.tx.stats.queued += Len;
     USBD_CDC_SetTxBuffer(&hUsbDeviceFS, usb_cdc_if.tx.irqBuf, Len);
     if (USBD_CDC_TransmitPacket(&hUsbDeviceFS) != USBD_OK) {
         usb_error |= CDC_ERROR_TRANSMIT;
         return -1; // Something went wrong in IO layer.
     }
     else {
+        countTransfer(Len);
         usb_error &= ~(CDC_ERROR_DELAYED_TRANSMIT | CDC_ERROR_TRANSMIT);
     }
 
     // All good.
+    checkWatermarks();
 
-    return Len;
+    return Len + rest;
+}
+
+int usb_cdc_vprintf(const char *format, va_list args)
+{
+    if (!usb_cdc_if.tx.ctx)
+        return -1; // Error, USB CDC is not initialized
+
+    USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData;
+    printSink_t sink = { false, usb_cdc_if.tx.allOrNothing, false, 0, 0, 0 };
+
+    // Idle with nothing queued, format straight into the transfer buffer. Else into the ring,
+    // which CDC_TransmitCplt_FS empties.
+    HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
+    sink.direct = usb_cdc_if.tx.coalesceCycles == 0 && hcdc->TxState == 0 &&
+                  circular_buf_empty(usb_cdc_if.tx.ctx);
+    HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+
+    int len = vformat(printWrite, &sink, format, args);
+    if (len < 0)
+        return -1; // Staged output is not committed
+
+    // All-or-nothing formats once. The staged output is added to the ring at once, or dropped as a
+    // whole if it did not fit.
+    if (sink.stage)
+    {
+        if (sink.full) {
+            usb_cdc_if.tx.stats.dropped += len;
+            usb_error |= CDC_ERROR_TX_FULL;
+            return 0;
+        }
+
+        HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
+        commitTx(sink.staged);
+        HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+        usb_error &= ~CDC_ERROR_TX_FULL;
+    }
+
+    // Bytes that did not fit are counted as dropped by queueTx
+    if (sink.written < (size_t) len) {
+        usb_error |= CDC_ERROR_CROPPED_TRANSMIT;
+    }
+    else {
+        usb_error &= ~CDC_ERROR_CROPPED_TRANSMIT;
+    }
+
+    uint8_t result = USBD_OK;
+    bool started = false;
+    if (sink.direct && sink.directLen != 0)
+    {
+        // Output beyond tx.irqBuf is in the ring, sent when this transfer completes
+        usb_cdc_if.tx.inFlight = 0;
+        usb_cdc_if.tx.stats.queued += sink.directLen;
+        USBD_CDC_SetTxBuffer(&hUsbDeviceFS, usb_cdc_if.tx.irqBuf, sink.directLen);
+        result = USBD_CDC_TransmitPacket(&hUsbDeviceFS);
+        if (result != USBD_OK) {
+            usb_error |= CDC_ERROR_TRANSMIT;
+            return -1; // Something went wrong in IO layer.
+        }
+        countTransfer(sink.directLen);
+        started = true;
+    }
+    else if (!sink.direct)
+    {
+        // The transfer may have completed while formatting, start it again if so
+        HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
+        result = startQueued(&started);
+        HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+
+        if (result != USBD_OK)
+            usb_error |= CDC_ERROR_TRANSMIT; // Kept in the ring and retried
+    }
+
+    if (started) {
+        usb_error &= ~(CDC_ERROR_DELAYED_TRANSMIT | CDC_ERROR_TRANSMIT);
+    }
+    checkWatermarks();
+
+    return sink.written;
 }
 
 size_t usb_cdc_tx_available()
@@ -196,6 +393,93 @@ size_t usb_cdc_tx_available()
 }
 
 
+void usb_cdc_tx_coalesce(uint32_t timeoutUs)
+{
+    if (timeoutUs != 0)
+    {
+        // The cycle counter timestamps the oldest queued byte
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
+    usb_cdc_if.tx.coalesceCycles = timeoutUs * (SystemCoreClock / 1000000);
+    HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+
+    if (timeoutUs == 0)
+        usb_cdc_tx_flush(); // Nothing must be left behind in the ring
+}
+
+int usb_cdc_tx_flush()
+{
+    if (!usb_cdc_if.tx.ctx)
+        return -1; // Error, USB CDC is not initialized
+
+    USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData;
+    uint8_t result = USBD_OK;
+
+    HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
+    if (hcdc->TxState == 0)
+        result = transmitFromRing();
+    // More than one transfer, or busy. Let CDC_TransmitCplt_FS send the rest.
+    usb_cdc_if.tx.flushPending = circular_buf_size(usb_cdc_if.tx.ctx) != usb_cdc_if.tx.inFlight;
+    HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+
+    if (result != USBD_OK) {
+        usb_error |= CDC_ERROR_TRANSMIT;
+        return -1;
+    }
+    return 0;
+}
+
+void usb_cdc_tx_poll()
+{
+    if (!usb_cdc_if.tx.ctx)
+        return;
+
+    // Coalesced data that timed out, or data kept in the ring after a failed transfer
+    bool started;
+    HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
+    uint8_t result = startQueued(&started);
+    HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+
+    if (result != USBD_OK)
+        usb_error |= CDC_ERROR_TRANSMIT;
+    else if (started)
+        usb_error &= ~(CDC_ERROR_DELAYED_TRANSMIT | CDC_ERROR_TRANSMIT);
+
+    checkWatermarks();
+}
+
+void usb_cdc_tx_flow_control(bool allOrNothing, size_t lowWatermark, size_t highWatermark,
+                             usb_cdc_watermark_t watermark)
+{
+    usb_cdc_if.tx.allOrNothing = allOrNothing;
+    usb_cdc_if.tx.lowWatermark = lowWatermark;
+    usb_cdc_if.tx.highWatermark = highWatermark;
+    usb_cdc_if.tx.watermark = watermark;
+    usb_cdc_if.tx.throttled = false;
+}
+
+bool usb_cdc_tx_throttled()
+{
+    return usb_cdc_if.tx.throttled;
+}
+
+void usb_cdc_tx_stats(usb_cdc_tx_stats_t *stats)
+{
+    HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
+    *stats = usb_cdc_if.tx.stats;
+    HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+}
+
+void usb_cdc_tx_stats_reset()
+{
+    HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
+    memset(&usb_cdc_if.tx.stats, 0, sizeof(usb_cdc_if.tx.stats));
+    HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+}
+
 uint32_t isCdcError() {
     return usb_error;
 }
@@ -216,10 +500,16 @@ static int8_t CDC_Init_FS(void)
     // Setup TX Buffer
     USBD_CDC_SetTxBuffer(&hUsbDeviceFS, usb_cdc_if.tx.irqBuf, 0);
     usb_cdc_if.tx.ctx = circular_buf_init_static(&tx_cb, tx_buf, CIRCULAR_BUFFER_SIZE);
+    usb_cdc_if.tx.inFlight = 0;
+    usb_cdc_if.tx.flushPending = false;
 
     // Setup RX Buffer
     USBD_CDC_SetRxBuffer(&hUsbDeviceFS, usb_cdc_if.rx.irqBuf);
-    usb_cdc_if.rx.ctx = circular_buf_init_static(&rx_cb, rx_buf, CIRCULAR_BUFFER_SIZE);
+    spsc_ring_init(&rx_ring, rx_buf, CIRCULAR_BUFFER_SIZE);
+    usb_cdc_if.rx.ctx = &rx_ring;
+    usb_cdc_if.rx.lineHead = 0;
+    usb_cdc_if.rx.lineTail = 0;
+    usb_cdc_if.rx.lineLen = 0;
 
     // Default is no host attached.
     usb_cdc_if.isComPortOpen = closed;
@@ -330,10 +620,9 @@ static int8_t CDC_Receive_FS(uint8_t* Buf, uint32_t *Len)
 
     uint16_t len = (uint16_t)*Len;
 
-    // Update circular buffer with incoming values
-    for(uint8_t i = 0; i < len; i++) {
-        circular_buf_put(usb_cdc_if.rx.ctx, Buf[i]);
-    }
+    // Update circular buffer with incoming values and queue where complete lines end
+    size_t start = usb_cdc_if.rx.ctx->head;
+    findLines(Buf, spsc_ring_write(usb_cdc_if.rx.ctx, Buf, len), start);
 
     memset(Buf, '\0', len); // clear the buffer
 
@@ -363,20 +652,15 @@ static int8_t CDC_TransmitCplt_FS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
 
     uint8_t result = USBD_OK;
 
-    // Fill in the next number of bytes.
-    uint16_t len = 0;
-    for (uint8_t *ptr = usb_cdc_if.tx.irqBuf; ptr < &usb_cdc_if.tx.irqBuf[sizeof(usb_cdc_if.tx.irqBuf)]; ptr++)
-    {
-        if (circular_buf_get(usb_cdc_if.tx.ctx, ptr) != 0) {
-            break; // No more bytes ready to transmit.
-        }
-        len++; // Yet another byte to send.
-    }
+    // The previous packet sent from the ring is done, release its bytes
+    circular_buf_commit_read(usb_cdc_if.tx.ctx, usb_cdc_if.tx.inFlight);
+    usb_cdc_if.tx.inFlight = 0;
 
-    if (len != 0)
+    // Re-arm at once with the next bytes, unless coalescing is waiting for more
+    if (usb_cdc_if.tx.coalesceCycles == 0 || usb_cdc_if.tx.flushPending || isCoalesceDue())
     {
-        USBD_CDC_SetTxBuffer(&hUsbDeviceFS, usb_cdc_if.tx.irqBuf, len);
-        result = USBD_CDC_TransmitPacket(&hUsbDeviceFS);
+        result = transmitFromRing();
+        usb_cdc_if.tx.flushPending &= circular_buf_size(usb_cdc_if.tx.ctx) != usb_cdc_if.tx.inFlight;
     }
 
     if(result != USBD_OK) {
@@ -388,3 +672,262 @@ static int8_t CDC_TransmitCplt_FS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
 
     return result;
 }
+
+/*!
+** @brief Starts an IN transfer with the oldest bytes of the transmit ring, directly from the ring
+**        memory. A transfer is at most half the ring, so the main loop stages the next transfer in
+**        the other half while this one is on the wire (ping-pong). A wrapped ring takes two
+**        transfers. Must be called from the USB interrupt or with it disabled.
+** @return USBD_OK if the transfer started or there is nothing to send
+*/
+static uint8_t transmitFromRing()
+{
+    const uint8_t *data;
+    size_t len = circular_buf_peek_contiguous(usb_cdc_if.tx.ctx, &data);
+    if (len > CDC_TX_TRANSFER_SIZE)
+        len = CDC_TX_TRANSFER_SIZE;
+
+    if (len == 0)
+        return USBD_OK;
+
+    USBD_CDC_SetTxBuffer(&hUsbDeviceFS, (uint8_t *) data, len);
+    uint8_t result = USBD_CDC_TransmitPacket(&hUsbDeviceFS);
+
+    if (result == USBD_OK) {
+        usb_cdc_if.tx.inFlight = len;
+        countTransfer(len);
+    }
+    else {
+        usb_cdc_if.tx.stats.retries++; // Kept in the ring, retried by usb_cdc_tx_poll or the next write
+    }
+
+    return result;
+}
+
+/*!
+** @brief Queues bytes in the transmit ring, counting what does not fit as dropped.
+**        Must be called with the USB interrupt disabled.
+** @return Number of bytes queued
+*/
+static size_t queueTx(const uint8_t* Buf, size_t Len)
+{
+    size_t len = circular_buf_stage(usb_cdc_if.tx.ctx, 0, Buf, Len);
+    usb_cdc_if.tx.stats.dropped += Len - len;
+    commitTx(len);
+
+    return len;
+}
+
+/*!
+** @brief Adds Len bytes staged in the transmit ring to it. Must be called with the USB interrupt
+**        disabled.
+*/
+static void commitTx(size_t Len)
+{
+    // Coalescing times out from the oldest byte that is not being transmitted
+    if (circular_buf_size(usb_cdc_if.tx.ctx) == usb_cdc_if.tx.inFlight)
+        usb_cdc_if.tx.queuedAt = DWT->CYCCNT;
+
+    circular_buf_commit_write(usb_cdc_if.tx.ctx, Len);
+    usb_cdc_if.tx.stats.queued += Len;
+
+    size_t fill = circular_buf_size(usb_cdc_if.tx.ctx);
+    if (fill > usb_cdc_if.tx.stats.peakFill)
+        usb_cdc_if.tx.stats.peakFill = fill;
+}
+
+/*!
+** @brief All-or-nothing check of a write of Len bytes, always true if all-or-nothing is off.
+**        Must be called with the USB interrupt disabled.
+** @param direct The write starts in tx.irqBuf, the rest goes to the ring
+*/
+static bool acceptWrite(bool direct, size_t Len)
+{
+    if (!usb_cdc_if.tx.allOrNothing)
+        return true;
+
+    size_t room = circular_buf_capacity(usb_cdc_if.tx.ctx) - circular_buf_size(usb_cdc_if.tx.ctx);
+    if (direct)
+        room += sizeof(usb_cdc_if.tx.irqBuf);
+
+    if (Len > room) {
+        usb_cdc_if.tx.stats.dropped += Len;
+        usb_error |= CDC_ERROR_TX_FULL;
+        return false;
+    }
+
+    usb_error &= ~CDC_ERROR_TX_FULL;
+    return true;
+}
+
+/*!
+** @brief Starts a transfer of the data queued in the ring if the endpoint is idle, unless
+**        coalescing is waiting for more. Must be called with the USB interrupt disabled.
+** @param started Set true if a transfer was started
+*/
+static uint8_t startQueued(bool *started)
+{
+    USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData;
+    uint8_t result = USBD_OK;
+
+    *started = false;
+    if (hcdc->TxState == 0 && usb_cdc_if.tx.inFlight == 0 && !circular_buf_empty(usb_cdc_if.tx.ctx) &&
+       (usb_cdc_if.tx.coalesceCycles == 0 || isCoalesceDue()))
+    {
+        result = transmitFromRing();
+        *started = (result == USBD_OK);
+    }
+
+    return result;
+}
+
+/*!
+** @brief Calls the watermark function when the ring fill reaches the high watermark, and again
+**        when it has fallen to the low watermark. Called from the main loop, not the interrupt.
+*/
+static void checkWatermarks()
+{
+    if (usb_cdc_if.tx.highWatermark == 0)
+        return;
+
+    HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
+    size_t fill = circular_buf_size(usb_cdc_if.tx.ctx);
+    HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+
+    if (!usb_cdc_if.tx.throttled && fill >= usb_cdc_if.tx.highWatermark)
+    {
+        usb_cdc_if.tx.throttled = true;
+        if (usb_cdc_if.tx.watermark)
+            usb_cdc_if.tx.watermark(true);
+    }
+    else if (usb_cdc_if.tx.throttled && fill <= usb_cdc_if.tx.lowWatermark)
+    {
+        usb_cdc_if.tx.throttled = false;
+        if (usb_cdc_if.tx.watermark)
+            usb_cdc_if.tx.watermark(false);
+    }
+}
+
+/*!
+** @brief vformat output of usb_cdc_vprintf. Fills tx.irqBuf if the endpoint was idle, the rest
+**        is queued in the ring, or staged in it with all-or-nothing.
+*/
+static void printWrite(void *ctx, const char *data, size_t len)
+{
+    printSink_t *sink = (printSink_t *) ctx;
+
+    if (sink->direct && sink->directLen < sizeof(usb_cdc_if.tx.irqBuf))
+    {
+        size_t room = sizeof(usb_cdc_if.tx.irqBuf) - sink->directLen;
+        size_t n = (len < room) ? len : room;
+
+        memcpy(&usb_cdc_if.tx.irqBuf[sink->directLen], data, n);
+        sink->directLen += n;
+        sink->written += n;
+        data += n;
+        len -= n;
+    }
+
+    if (len != 0 && sink->stage && !sink->full)
+    {
+        // Behind the ring head, the interrupt only frees space until the output is committed
+        HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
+        size_t n = circular_buf_stage(usb_cdc_if.tx.ctx, sink->staged, (const uint8_t *) data, len);
+        HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+
+        sink->staged += n;
+        sink->written += n;
+        sink->full |= (n < len);
+    }
+    else if (len != 0 && !sink->stage)
+    {
+        HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
+        sink->written += queueTx((const uint8_t *) data, len);
+        HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+    }
+}
+
+/*!
+** @brief Returns true if the bytes waiting in the transmit ring fill a packet or have timed out
+*/
+static bool isCoalesceDue()
+{
+    size_t unsent = circular_buf_size(usb_cdc_if.tx.ctx) - usb_cdc_if.tx.inFlight;
+
+    return unsent >= CDC_DATA_FS_MAX_PACKET_SIZE ||
+          (unsent != 0 && DWT->CYCCNT - usb_cdc_if.tx.queuedAt >= usb_cdc_if.tx.coalesceCycles);
+}
+
+/*!
+** @brief Updates the transmit counters. The USB stack ends a transfer of a whole number of packets
+**        with a zero length packet, so a transfer of len bytes takes len / 64 + 1 packets.
+*/
+static void countTransfer(size_t len)
+{
+    usb_cdc_if.tx.stats.transfers++;
+    usb_cdc_if.tx.stats.packets += len / CDC_DATA_FS_MAX_PACKET_SIZE + 1;
+    usb_cdc_if.tx.stats.bytes += len;
+}
+
+/*!
+** @brief Queues the ring index past each terminator of a non empty line in the len bytes written
+**        from Buf at ring index start. Called from the USB interrupt.
+*/
+static void findLines(const uint8_t* Buf, size_t len, size_t start)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        if (!isLineEnd(Buf[i]))
+        {
+            usb_cdc_if.rx.lineLen++;
+            continue;
+        }
+        if (usb_cdc_if.rx.lineLen == 0)
+            continue; // Empty line, e.g. the \n of \r\n
+
+        usb_cdc_if.rx.lineLen = 0;
+        size_t head = usb_cdc_if.rx.lineHead;
+        if (head - __atomic_load_n(&usb_cdc_if.rx.lineTail, __ATOMIC_ACQUIRE) < CDC_RX_LINE_QUEUE)
+        {
+            usb_cdc_if.rx.lines[head & (CDC_RX_LINE_QUEUE - 1)] = start + i + 1;
+            __atomic_store_n(&usb_cdc_if.rx.lineHead, head + 1, __ATOMIC_RELEASE);
+        }
+        else
+        {
+            // Queue full, extend the newest entry. The main loop is reading the oldest one.
+            usb_cdc_if.rx.lines[(head - 1) & (CDC_RX_LINE_QUEUE - 1)] = start + i + 1;
+        }
+    }
+}
+
+static bool isLineEnd(uint8_t c)
+{
+    return c == '\r' || c == '\n';
+}
+
+/*!
+** @brief Discards the received bytes up to and including the next line terminator, looking at
+**        most pending bytes ahead
+*/
+static void skipLineRest(spsc_ring_t *ring, size_t pending)
+{
+    uint8_t chunk[32];
+
+    while (pending != 0)
+    {
+        size_t n = spsc_ring_peek(ring, chunk, (pending < sizeof(chunk)) ? pending : sizeof(chunk));
+        if (n == 0)
+            return;
+
+        size_t i = 0;
+        while (i < n && !isLineEnd(chunk[i]))
+            i++;
+
+        if (i < n) {
+            spsc_ring_skip(ring, i + 1);
+            return;
+        }
+        spsc_ring_skip(ring, n);
+        pending -= n;
+    }
+}
@@ -0,0 +1,307 @@
+/*!
+** @file   vformat.c
+** @brief  printf style formatting streamed through a write function. Literal text and strings
+**         are passed on as they are, each numeric conversion is formatted by snprintf with its
+**         own conversion specification.
+** @date   15/10/2026
+*/
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "vformat.h"
+
+/***************************************************************************************************
+** DEFINES
+***************************************************************************************************/
+
+#define SPEC_MAX 32 // Longest conversion specification
+
+typedef enum {
+    LEN_NONE, LEN_HH, LEN_H, LEN_L, LEN_LL, LEN_J, LEN_Z, LEN_T, LEN_LD
+} lengthModifier_t;
+
+/***************************************************************************************************
+** PRIVATE FUNCTION DEFINITIONS
+***************************************************************************************************/
+
+/*!
+** @brief Writes count spaces, or zeros
+*/
+static void pad(vformatWrite write, void *ctx, int count, bool zeros)
+{
+    static const char spaces[] = "                ";
+    static const char zeroes[] = "0000000000000000";
+
+    while (count > 0)
+    {
+        int len = (count < (int) sizeof(spaces) - 1) ? count : (int) sizeof(spaces) - 1;
+        write(ctx, zeros ? zeroes : spaces, len);
+        count -= len;
+    }
+}
+
+/*!
+** @brief Parses the length modifier at *p and copies it to the specification
+*/
+static lengthModifier_t lengthModifier(const char **p, char *spec, size_t *n)
+{
+    const char *s = *p;
+    lengthModifier_t mod = LEN_NONE;
+
+    switch (*s)
+    {
+    case 'h': mod = (s[1] == 'h') ? LEN_HH : LEN_H; break;
+    case 'l': mod = (s[1] == 'l') ? LEN_LL : LEN_L; break;
+    case 'j': mod = LEN_J;  break;
+    case 'z': mod = LEN_Z;  break;
+    case 't': mod = LEN_T;  break;
+    case 'L': mod = LEN_LD; break;
+    default:  return LEN_NONE;
+    }
+
+    size_t len = (mod == LEN_HH || mod == LEN_LL) ? 2 : 1;
+    memcpy(&spec[*n], s, len);
+    *n += len;
+    *p += len;
+    return mod;
+}
+
+/*!
+** @brief Parses the digits at *p, at most 8, and copies them to the specification unless spec is
+**        NULL
+** @return The value of the digits
+*/
+static int digits(const char **p, char *spec, size_t *n)
+{
+    int value = 0;
+
+    for (int count = 0; **p >= '0' && **p <= '9' && count < 8; count++)
+    {
+        value = value * 10 + (**p - '0');
+        if (spec)
+            spec[(*n)++] = **p;
+        (*p)++;
+    }
+    return value;
+}
+
+/*!
+** @brief Length of the sign and 0x prefix of a formatted number, zero padding goes after them
+*/
+static size_t prefixLength(const char *number, char conversion)
+{
+    size_t len = (number[0] == '-' || number[0] == '+' || number[0] == ' ') ? 1 : 0;
+
+    if (strchr("xXaA", conversion) && number[len] == '0' &&
+        (number[len + 1] == 'x' || number[len + 1] == 'X'))
+        len += 2;
+    return len;
+}
+
+/***************************************************************************************************
+** PUBLIC FUNCTION DEFINITIONS
+***************************************************************************************************/
+
+int vformat(vformatWrite write, void *ctx, const char *format, va_list args)
+{
+    char spec[2 * SPEC_MAX]; // Room for '*' width and precision replaced by their values
+    char number[VFORMAT_NUMBER_MAX];
+    int total = 0;
+    va_list ap;
+
+    va_copy(ap, args);
+    while (*format)
+    {
+        // Literal text up to the next conversion
+        const char *p = strchr(format, '%');
+        size_t literal = p ? (size_t) (p - format) : strlen(format);
+        if (literal)
+        {
+            write(ctx, format, literal);
+            total += literal;
+        }
+        if (!p)
+            break;
+
+        // Flags, width and precision
+        // The width is left out of the specification, the field is padded by pad() so it can
+        // be wider than number
+        size_t n = 0;
+        int width = -1, precision = -1;
+        bool left = false, zeros = false;
+
+        spec[n++] = *p++;
+        while (*p && strchr("-+ #0", *p) && n < SPEC_MAX - 8)
+        {
+            left |= (*p == '-');
+            zeros |= (*p == '0');
+            spec[n++] = *p++;
+        }
+
+        if (*p == '*')
+        {
+            width = va_arg(ap, int);
+            if (width < 0)
+            {
+                left = true;
+                width = (width == INT_MIN) ? INT_MAX : -width;
+            }
+            p++;
+        }
+        else if (*p >= '0' && *p <= '9')
+        {
+            width = digits(&p, NULL, &n);
+        }
+
+        if (*p == '.')
+        {
+            spec[n++] = *p++;
+            if (*p == '*')
+            {
+                precision = va_arg(ap, int);
+                if (precision < 0)
+                    n--; // Negative is as if the precision is omitted
+                else
+                    n += snprintf(&spec[n], sizeof(spec) - n, "%d", precision);
+                p++;
+            }
+            else
+            {
+                precision = digits(&p, spec, &n);
+            }
+        }
+
+        lengthModifier_t mod = lengthModifier(&p, spec, &n);
+
+        if (n >= SPEC_MAX - 2 || *p == '\0')
+        {
+            va_end(ap);
+            return -1;
+        }
+
+        const char conversion = *p++;
+        spec[n++] = conversion;
+        spec[n] = '\0';
+        format = p;
+
+        int len = 0;
+        switch (conversion)
+        {
+        case '%':
+            write(ctx, "%", 1);
+            total++;
+            continue;
+
+        case 's':
+        {
+            if (mod == LEN_L)
+            {
+                va_end(ap);
+                return -1; // Wide strings are not supported
+            }
+
+            // Passed on directly, any length
+            const char *str = va_arg(ap, const char *);
+            if (!str)
+                str = "(null)";
+
+            size_t strLen = 0;
+            while ((precision < 0 || strLen < (size_t) precision) && str[strLen])
+                strLen++;
+
+            int fill = (width > (int) strLen) ? width - (int) strLen : 0;
+            if (!left)
+                pad(write, ctx, fill, false);
+            write(ctx, str, strLen);
+            if (left)
+                pad(write, ctx, fill, false);
+            total += strLen + fill;
+            continue;
+        }
+
+        case 'd': case 'i':
+            switch (mod)
+            {
+            case LEN_L:  len = snprintf(number, sizeof(number), spec, va_arg(ap, long));      break;
+            case LEN_LL: len = snprintf(number, sizeof(number), spec, va_arg(ap, long long)); break;
+            case LEN_J:  len = snprintf(number, sizeof(number), spec, va_arg(ap, intmax_t));  break;
+            case LEN_Z:  len = snprintf(number, sizeof(number), spec, va_arg(ap, size_t));    break;
+            case LEN_T:  len = snprintf(number, sizeof(number), spec, va_arg(ap, ptrdiff_t)); break;
+            default:     len = snprintf(number, sizeof(number), spec, va_arg(ap, int));       break;
+            }
+            break;
+
+        case 'u': case 'o': case 'x': case 'X':
+            switch (mod)
+            {
+            case LEN_L:  len = snprintf(number, sizeof(number), spec, va_arg(ap, unsigned long));      break;
+            case LEN_LL: len = snprintf(number, sizeof(number), spec, va_arg(ap, unsigned long long)); break;
+            case LEN_J:  len = snprintf(number, sizeof(number), spec, va_arg(ap, uintmax_t));          break;
+            case LEN_Z:  len = snprintf(number, sizeof(number), spec, va_arg(ap, size_t));             break;
+            case LEN_T:  len = snprintf(number, sizeof(number), spec, va_arg(ap, ptrdiff_t));          break;
+            default:     len = snprintf(number, sizeof(number), spec, va_arg(ap, unsigned int));       break;
+            }
+            break;
+
+        case 'c':
+            if (mod == LEN_L)
+            {
+                va_end(ap);
+                return -1; // Wide characters are not supported
+            }
+            len = snprintf(number, sizeof(number), spec, va_arg(ap, int));
+            break;
+
+        case 'p':
+            len = snprintf(number, sizeof(number), spec, va_arg(ap, void *));
+            break;
+
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            if (mod == LEN_LD)
+                len = snprintf(number, sizeof(number), spec, va_arg(ap, long double));
+            else
+                len = snprintf(number, sizeof(number), spec, va_arg(ap, double));
+            break;
+
+        default:
+            va_end(ap);
+            return -1; // Unknown conversion or %n
+        }
+
+        if (len < 0 || len >= (int) sizeof(number))
+        {
+            va_end(ap);
+            return -1; // Does not fit in number, e.g. %.70f, it is not cut silently
+        }
+
+        // Zero padding as printf, not for left justified fields, integers with a precision,
+        // %c, %p, infinity and NaN
+        int fill = (width > len) ? width - len : 0;
+        size_t prefix = prefixLength(number, conversion);
+        bool integer = strchr("diuoxX", conversion) != NULL;
+        bool finite = number[prefix] >= '0' && number[prefix] <= '9';
+        if (zeros && !left && strchr("diuoxXfFeEgGaA", conversion) &&
+            (integer ? precision < 0 : finite))
+        {
+            write(ctx, number, prefix);
+            pad(write, ctx, fill, true);
+            write(ctx, &number[prefix], len - prefix);
+        }
+        else
+        {
+            if (!left)
+                pad(write, ctx, fill, false);
+            write(ctx, number, len);
+            if (left)
+                pad(write, ctx, fill, false);
+        }
+        total += len + fill;
+    }
+
+    va_end(ap);
+    return total;
+}
@@ -9,8 +9,20 @@
 #define INC_CAPROTOCOL_H_
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "HAL_otp.h"
 
+/***************************************************************************************************
+** DEFINES
+***************************************************************************************************/
+
+#define CA_MAX_COMMANDS 32  // Generic and board specific commands
+
+// caRegisterCommand flags
+#define CA_CMD_REPLACE      0x01  // Replace a command already registered, e.g. a generic one
+#define CA_CMD_NEEDS_ARGS   0x02  // The command without arguments is a parse error
+
 /***************************************************************************************************
 ** STRUCTURES
 ***************************************************************************************************/
@@ -24,6 +36,9 @@ typedef struct
 } CACalibration;
 
 typedef int (*ReaderFn)(uint8_t* rxBuf);
+// Copies the next complete line without terminator into buf and zero terminates it, e.g. usbRxLine.
+// Returns the line length, 0 if there is no complete line.
+typedef int (*LineReaderFn)(uint8_t* buf, size_t size);
 typedef struct
 {
     // Called if message is not found. Overwrite to get info about invalid input
@@ -54,15 +69,32 @@ typedef struct
     /* Print generic uptime information */
     void (*uptime)(const char* inputString);
 
+    // Output format of measurements, "STREAM bin" selects binary frames (see binaryStream.h),
+    // "STREAM csv" ASCII lines.
+    void (*streamFormat)(bool binary);
+
     struct CAProtocolData *data; // Private data for CAProtocol.
 } CAProtocolCtx;
 
+// Handler of a registered command, input is the whole message e.g. "CAL 1,1.0,0.0,10".
+// Returns 0 if handled, -1 on a parse error which is reported as an undefined message.
+typedef int (*CACommandFn)(CAProtocolCtx* ctx, const char* input);
+
 /***************************************************************************************************
 ** PUBLIC FUNCTION DECLARATIONS
 ***************************************************************************************************/
 
 void inputCAProtocol(CAProtocolCtx* ctx);
 void initCAProtocol(CAProtocolCtx* ctx, ReaderFn fn);
+// As initCAProtocol, but messages are fetched a line at a time instead of byte by byte.
+void initCAProtocolLines(CAProtocolCtx* ctx, LineReaderFn fn);
 void flushCAProtocol(CAProtocolCtx* ctx);
 
+// Adds a command to the sorted command table, which is searched with a single binary search per
+// message. The command name is the leading letters and underscores of a message, so "p10 on" is
+// dispatched to "p". Call after initCAProtocol, name must stay valid as it is not copied.
+// Returns 0 on success, -1 if the table is full, the name is invalid or already registered
+// without CA_CMD_REPLACE.
+int caRegisterCommand(CAProtocolCtx* ctx, const char* name, CACommandFn handler, uint32_t flags);
+
 #endif /* INC_CAPROTOCOL_H_ */
@@ -23,10 +23,20 @@
 ** TYPEDEFS
 ***************************************************************************************************/
 
+typedef struct {
+    const char* name;
+    size_t nameLen;
+    CACommandFn handler;
+    uint32_t flags;
+} CACommand;
+
 typedef struct CAProtocolData {
     size_t len;         // Length of current data.
     uint8_t buf[512];   // Buffer for the string fetched from the circular buffer.
     ReaderFn rxReader;  // Reader for the buffer
+    LineReaderFn lineReader;  // Reader of whole lines, used instead of rxReader if set
+    CACommand commands[CA_MAX_COMMANDS];  // Sorted by name for binary search
+    int noOfCommands;
 } CAProtocolData;
 
 /***************************************************************************************************
@@ -36,7 +46,11 @@ typedef struct CAProtocolData {
 static void calibration(CAProtocolCtx* ctx, const char* input);
 static void logging(CAProtocolCtx* ctx, const char* input);
 static void otp_write(CAProtocolCtx* ctx, const char* input);
+static void streamFormat(CAProtocolCtx* ctx, const char* input);
 static int CAgetMsg(CAProtocolCtx* ctx);
+static size_t commandNameLen(const char* input);
+static int compareName(const CACommand* cmd, const char* name, size_t nameLen);
+static const CACommand* findCommand(const CAProtocolData* data, const char* input, size_t nameLen);
 
 /***************************************************************************************************
 ** PRIVATE FUNCTION DEFINITIONS
@@ -153,10 +167,30 @@ static void otp_write(CAProtocolCtx* ctx, const char* input) {
     ctx->undefined(input);
 }
 
+static void streamFormat(CAProtocolCtx* ctx, const char* input) {
+    char* idx = strchr((char*)input, ' ');
+
+    if (idx && strcmp(&idx[1], "bin") == 0) {
+        ctx->streamFormat(true);
+    }
+    else if (idx && strcmp(&idx[1], "csv") == 0) {
+        ctx->streamFormat(false);
+    }
+    else {
+        ctx->undefined(input);
+    }
+}
+
 static int CAgetMsg(CAProtocolCtx* ctx) {
     CAProtocolData* protocolData = ctx->data;
     int msgLen = 0;
 
+    if (protocolData->lineReader) {
+        // The line is assembled on reception, fetch it in one go.
+        msgLen = protocolData->lineReader(protocolData->buf, sizeof(protocolData->buf));
+        return (msgLen > 0) ? msgLen : 0;
+    }
+
     while (msgLen == 0) {
         uint8_t rxByte;
 
@@ -195,89 +229,199 @@ static int CAgetMsg(CAProtocolCtx* ctx) {
     return msgLen;
 }
 
+/*!
+** @brief Length of the command name at the start of input, the leading letters and underscores.
+**        "CAL 1,2,3" gives "CAL" and "p10 on" gives "p".
+*/
+static size_t commandNameLen(const char* input) {
+    size_t len = 0;
+    while ((input[len] >= 'a' && input[len] <= 'z') || (input[len] >= 'A' && input[len] <= 'Z') ||
+           input[len] == '_') {
+        len++;
+    }
+    return len;
+}
+
+static int compareName(const CACommand* cmd, const char* name, size_t nameLen) {
+    size_t len = (cmd->nameLen < nameLen) ? cmd->nameLen : nameLen;
+    int cmp = strncmp(cmd->name, name, len);
+    if (cmp != 0) {
+        return cmp;
+    }
+    return (cmd->nameLen < nameLen) ? -1 : (cmd->nameLen > nameLen) ? 1 : 0;
+}
+
+/*!
+** @brief Binary search of the command table, returns NULL if the command is not registered.
+*/
+static const CACommand* findCommand(const CAProtocolData* data, const char* input, size_t nameLen) {
+    int lower = 0;
+    int upper = data->noOfCommands - 1;
+
+    while (lower <= upper) {
+        int mid = (lower + upper) / 2;
+        int cmp = compareName(&data->commands[mid], input, nameLen);
+        if (cmp == 0) {
+            return &data->commands[mid];
+        }
+        if (cmp < 0) {
+            lower = mid + 1;
+        }
+        else {
+            upper = mid - 1;
+        }
+    }
+    return NULL;
+}
+
+/***************************************************************************************************
+** GENERIC COMMAND HANDLERS
+***************************************************************************************************/
+
+static int serialCmd(CAProtocolCtx* ctx, const char* input) {
+    if (!ctx->printHeader) {
+        return -1;
+    }
+    ctx->printHeader();
+    return 0;
+}
+
+static int statusDefCmd(CAProtocolCtx* ctx, const char* input) {
+    CAPrintStatusDef(true);  // Print start of status definition message
+    if (ctx->printStatusDef) {
+        ctx->printStatusDef();  // Print board specific part of statusdefinition message
+    }
+    CAPrintStatusDef(false);  // Print end of status definition message
+    return 0;
+}
+
+static int statusCmd(CAProtocolCtx* ctx, const char* input) {
+    CAPrintStatus(true);  // Print start of status message
+    if (ctx->printStatus) {
+        ctx->printStatus();  // Print board specific part of status message
+    }
+    CAPrintStatus(false);  // Print end of status message
+    return 0;
+}
+
+static int dfuCmd(CAProtocolCtx* ctx, const char* input) {
+    if (!ctx->jumpToBootLoader) {
+        return -1;
+    }
+    ctx->jumpToBootLoader();
+    return 0;
+}
+
+static int calibrationCmd(CAProtocolCtx* ctx, const char* input) {
+    if (!ctx->calibration) {
+        return -1;
+    }
+    calibration(ctx, input);
+    return 0;
+}
+
+static int loggingCmd(CAProtocolCtx* ctx, const char* input) {
+    if (!ctx->logging) {
+        return -1;
+    }
+    logging(ctx, input);
+    return 0;
+}
+
+static int otpCmd(CAProtocolCtx* ctx, const char* input) {
+    if (input[4] == 'r' && ctx->otpRead) {
+        ctx->otpRead();
+        return 0;
+    }
+    if (input[4] == 'w' && ctx->otpWrite) {
+        otp_write(ctx, input);
+        return 0;
+    }
+    return -1;
+}
+
+static int streamCmd(CAProtocolCtx* ctx, const char* input) {
+    if (!ctx->streamFormat) {
+        return -1;
+    }
+    streamFormat(ctx, input);
+    return 0;
+}
+
+static int uptimeCmd(CAProtocolCtx* ctx, const char* input) {
+    if (!ctx->uptime) {
+        return -1;
+    }
+    ctx->uptime(input);
+    return 0;
+}
+
 /***************************************************************************************************
 ** PUBLIC FUNCTION DEFINITIONS
 ***************************************************************************************************/
 
 void inputCAProtocol(CAProtocolCtx* ctx) {
-    int parseError = 1;
-
     int msgLen = CAgetMsg(ctx);
     if (msgLen == 0) {
         return;  // No message received
     }
 
     // A message is received i.e. a zero terminated string
-    char* input = (char*)ctx->data->buf;
-
-    if (strncmp(input, "Serial", 6) == 0) {
-        if (ctx->printHeader) {
-            ctx->printHeader();
-            parseError = 0;
+    const char* input = (const char*)ctx->data->buf;
+    size_t nameLen = commandNameLen(input);
+
+    const CACommand* cmd = findCommand(ctx->data, input, nameLen);
+    if (cmd) {
+        bool missingArgs = (cmd->flags & CA_CMD_NEEDS_ARGS) && input[nameLen] == '\0';
+        if (missingArgs || cmd->handler(ctx, input) != 0) {
+            HALundefined(input);
         }
     }
-    else if (strncmp(input, "StatusDef", 9) == 0) {
-        CAPrintStatusDef(true);  // Print start of status definition message
-        if (ctx->printStatusDef) {
-            ctx->printStatusDef();  // Print board specific part of statusdefinition message
-        }
-        CAPrintStatusDef(false);  // Print end of status definition message
-        parseError = 0;
+    else if (ctx->undefined) {
+        ctx->undefined(input);
     }
-    else if (strncmp(input, "Status", 6) == 0) {
-        CAPrintStatus(true);  // Print start of status message
-        if (ctx->printStatus) {
-            ctx->printStatus();  // Print board specific part of status message
-        }
-        CAPrintStatus(false);  // Print end of status message
-        parseError = 0;
+    else {
+        HALundefined(input);
     }
-    else if (strncmp(input, "DFU", 3) == 0) {
-        if (ctx->jumpToBootLoader) {
-            ctx->jumpToBootLoader();
-            parseError = 0;
-        }
+}
+
+int caRegisterCommand(CAProtocolCtx* ctx, const char* name, CACommandFn handler, uint32_t flags) {
+    CAProtocolData* data = ctx->data;
+    size_t nameLen = name ? strlen(name) : 0;
+
+    if (!handler || nameLen == 0 || commandNameLen(name) != nameLen) {
+        return -1;  // Name must be a whole command name, see commandNameLen.
     }
-    else if (strncmp(input, "CAL", 3) == 0) {
-        if (ctx->calibration) {
-            calibration(ctx, input);
-            parseError = 0;
+
+    // Insertion point keeping the table sorted
+    int idx = 0;
+    int upper = data->noOfCommands;
+    while (idx < upper) {
+        int mid = (idx + upper) / 2;
+        if (compareName(&data->commands[mid], name, nameLen) < 0) {
+            idx = mid + 1;
         }
-    }
-    else if (strncmp(input, "LOG", 3) == 0) {
-        if (ctx->logging) {
-            logging(ctx, input);
-            parseError = 0;
+        else {
+            upper = mid;
         }
     }
-    else if (strncmp(input, "OTP", 3) == 0) {
-        if (input[4] == 'r') {
-            if (ctx->otpRead) {
-                ctx->otpRead();
-                parseError = 0;
-            }
-        }
-        else if (input[4] == 'w') {
-            if (ctx->otpWrite) {
-                otp_write(ctx, input);
-                parseError = 0;
-            }
+
+    if (idx < data->noOfCommands && compareName(&data->commands[idx], name, nameLen) == 0) {
+        if (!(flags & CA_CMD_REPLACE)) {
+            return -1;  // Already registered
         }
     }
-    else if (strncmp(input, "uptime", 6) == 0) {
-        if (ctx->uptime) {
-            ctx->uptime(input);
-            parseError = 0;
+    else {
+        if (data->noOfCommands >= CA_MAX_COMMANDS) {
+            return -1;
         }
-    }
-    else if (ctx->undefined) {
-        ctx->undefined(input);
-        parseError = 0;
+        memmove(&data->commands[idx + 1], &data->commands[idx],
+                (data->noOfCommands - idx) * sizeof(CACommand));
+        data->noOfCommands++;
     }
 
-    if (parseError) {
-        HALundefined(input);
-    }
+    data->commands[idx] = (CACommand){name, nameLen, handler, flags};
+    return 0;
 }
 
 void initCAProtocol(CAProtocolCtx* ctx, ReaderFn fn) {
@@ -285,6 +429,24 @@ void initCAProtocol(CAProtocolCtx* ctx, ReaderFn fn) {
     memset(ctx->data->buf, 0, sizeof(ctx->data->buf));
     ctx->data->len = 0;
     ctx->data->rxReader = fn;
+    ctx->data->lineReader = NULL;
+    ctx->data->noOfCommands = 0;
+
+    // Generic commands, a board can replace them with CA_CMD_REPLACE.
+    caRegisterCommand(ctx, "Serial", serialCmd, 0);
+    caRegisterCommand(ctx, "StatusDef", statusDefCmd, 0);
+    caRegisterCommand(ctx, "Status", statusCmd, 0);
+    caRegisterCommand(ctx, "DFU", dfuCmd, 0);
+    caRegisterCommand(ctx, "CAL", calibrationCmd, 0);
+    caRegisterCommand(ctx, "LOG", loggingCmd, 0);
+    caRegisterCommand(ctx, "OTP", otpCmd, 0);
+    caRegisterCommand(ctx, "STREAM", streamCmd, 0);
+    caRegisterCommand(ctx, "uptime", uptimeCmd, 0);
+}
+
+void initCAProtocolLines(CAProtocolCtx* ctx, LineReaderFn fn) {
+    initCAProtocol(ctx, NULL);
+    ctx->data->lineReader = fn;
 }
 
 void flushCAProtocol(CAProtocolCtx* ctx) {
@@ -19,6 +19,17 @@
 #define RCC_FLAG_IWDGRST RCC_FLAG_IWDG1RST
 #endif
 
+/***************************************************************************************************
+** WEAK FUNCTION DEFINITIONS
+***************************************************************************************************/
+
+// Telemetry line of ADCMonitor for the status message. Replaced by the definition in ADCmonitor.c
+// when a board uses the ADCMonitor library, boards without it print nothing.
+__attribute__((weak)) const char* ADCMonitorStatus()
+{
+    return NULL;
+}
+
 /***************************************************************************************************
 ** PUBLIC FUNCTION DEFINITIONS
 ***************************************************************************************************/
@@ -49,6 +60,20 @@ void CAPrintStatus(bool printStart)
 {
     const char* buf = statusInfo(printStart);
     writeUSB(buf, strlen(buf));
+
+    if (printStart)
+    {
+        UsbTxCounters tx;
+        usbTxCounters(&tx);
+        USBnprintf("USB tx: %" PRIu32 " queued, %" PRIu32 " sent, %" PRIu32 " dropped, %" PRIu32
+                   " retries, peak fill %" PRIu32 "\r\n", tx.queued, tx.sent, tx.dropped, tx.retries, tx.peakFill);
+
+        const char* adcStatus = ADCMonitorStatus();
+        if (adcStatus != NULL)
+        {
+            writeUSB(adcStatus, strlen(adcStatus));
+        }
+    }
 }
 
 void CAPrintStatusDef(bool printStart)
@@ -114,6 +139,7 @@ bool CAhandleUserInputs(CAProtocolCtx* ctx, const char* startMsg)
     }
 
     inputCAProtocol(ctx);
+    usbTxPoll(); // Send coalesced output that has waited long enough
 
     return firstWriteHappened;
 }
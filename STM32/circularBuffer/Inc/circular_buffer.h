@@ -49,6 +49,42 @@ int circular_buf_put(cbuf_handle_t cbuf, uint8_t data);
 /// Returns 0 on success, -1 if the buffer is empty
 int circular_buf_get(cbuf_handle_t cbuf, uint8_t * data);
 
+/// Put up to len bytes from src, in at most two memcpy segments
+/// Requires: cbuf is valid and created by circular_buf_init
+/// Returns the number of bytes written, less than len if the buffer is full
+size_t circular_buf_write(cbuf_handle_t cbuf, const uint8_t* src, size_t len);
+
+/// Copy up to len bytes from src into the free space, offset bytes after the newest byte, without
+/// adding them. Readers do not see them until circular_buf_commit_write(cbuf, offset + len), so a
+/// write made of several pieces can be added at once, or dropped by not committing it.
+/// Requires: cbuf is valid and created by circular_buf_init
+/// Returns the number of bytes copied, less than len if the free space ends first
+size_t circular_buf_stage(cbuf_handle_t cbuf, size_t offset, const uint8_t* src, size_t len);
+
+/// Retrieve up to len bytes into dst, in at most two memcpy segments
+/// Requires: cbuf is valid and created by circular_buf_init
+/// Returns the number of bytes read, less than len if the buffer is empty
+size_t circular_buf_read(cbuf_handle_t cbuf, uint8_t* dst, size_t len);
+
+/// Zero-copy read: get the largest contiguous readable region, starting at the oldest byte
+/// The region stays valid (e.g. for DMA or USB) until it is released by circular_buf_commit_read
+/// Requires: cbuf is valid and created by circular_buf_init
+/// Returns the number of bytes at *data, 0 if the buffer is empty
+size_t circular_buf_peek_contiguous(cbuf_handle_t cbuf, const uint8_t** data);
+
+/// Release len bytes previously returned by circular_buf_peek_contiguous
+/// Requires: cbuf is valid and created by circular_buf_init, len <= circular_buf_size
+void circular_buf_commit_read(cbuf_handle_t cbuf, size_t len);
+
+/// Zero-copy write: get the largest contiguous writable region
+/// Requires: cbuf is valid and created by circular_buf_init
+/// Returns the number of bytes that can be written at *data, 0 if the buffer is full
+size_t circular_buf_reserve(cbuf_handle_t cbuf, uint8_t** data);
+
+/// Add len bytes written to the region returned by circular_buf_reserve
+/// Requires: cbuf is valid and created by circular_buf_init, len <= the reserved length
+void circular_buf_commit_write(cbuf_handle_t cbuf, size_t len);
+
 /// CHecks if the buffer is empty
 /// Requires: cbuf is valid and created by circular_buf_init
 /// Returns true if the buffer is empty
@@ -0,0 +1,74 @@
+#ifndef RING_BUFFER_H_
+#define RING_BUFFER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+  extern "C" {
+#endif
+
+/// What ring_buf_push does when the ring is full
+typedef enum {
+    RING_BUF_REJECT_NEW,        // Keep the stored elements, new elements are not stored
+    RING_BUF_OVERWRITE_OLDEST   // Store the new elements, the oldest are discarded
+} ring_buf_policy_t;
+
+/// Ring buffer of fixed size elements, e.g. int16_t samples, doubles or structs
+typedef struct ring_buf_t {
+    uint8_t * buffer;
+    size_t elemSize;            // Size of an element in bytes
+    size_t capacity;            // Number of elements in buffer
+    size_t head;                // Index of the oldest element
+    size_t count;               // Number of stored elements
+    ring_buf_policy_t policy;
+    uint32_t dropped;           // Elements rejected or overwritten since init/reset
+} ring_buf_t;
+
+/// Declare a ring buffer with static storage for n elements of type
+///     RING_BUF_STATIC(samples, int16_t, 256, RING_BUF_OVERWRITE_OLDEST);
+#define RING_BUF_STATIC(name, type, n, policy) \
+    static type name##_storage[n]; \
+    static ring_buf_t name = { (uint8_t *) name##_storage, sizeof(type), (n), 0, 0, (policy), 0 }
+
+/// Generate type checked wrappers prefix_push/prefix_pop/prefix_peek for elements of type
+///     RING_BUF_TYPED(sample_ring, int16_t)
+#define RING_BUF_TYPED(prefix, type) \
+    static inline size_t prefix##_push(ring_buf_t* ring, const type* elems, size_t n) \
+        { return ring_buf_push(ring, elems, n); } \
+    static inline size_t prefix##_pop(ring_buf_t* ring, type* elems, size_t n) \
+        { return ring_buf_pop(ring, elems, n); } \
+    static inline int prefix##_peek(ring_buf_t* ring, size_t idx, type* elem) \
+        { return ring_buf_peek(ring, idx, elem); }
+
+/// Pass in a storage buffer of capacity elements of elemSize bytes
+/// Returns 0 on success, -1 if the arguments are invalid
+int ring_buf_init(ring_buf_t* ring, void* storage, size_t elemSize, size_t capacity, ring_buf_policy_t policy);
+
+/// Reset the ring buffer to empty and clear the dropped counter
+void ring_buf_reset(ring_buf_t* ring);
+
+/// Store n elements, in at most two memcpy segments
+/// Returns the number of elements stored. With RING_BUF_OVERWRITE_OLDEST all n are stored (only
+/// the newest capacity elements are kept if n > capacity)
+size_t ring_buf_push(ring_buf_t* ring, const void* elems, size_t n);
+
+/// Retrieve up to n of the oldest elements, in at most two memcpy segments
+/// Returns the number of elements retrieved
+size_t ring_buf_pop(ring_buf_t* ring, void* elems, size_t n);
+
+/// Copy element idx without removing it, 0 is the oldest
+/// Returns 0 on success, -1 if idx >= ring_buf_count
+int ring_buf_peek(ring_buf_t* ring, size_t idx, void* elem);
+
+/// Returns the number of stored elements
+size_t ring_buf_count(ring_buf_t* ring);
+
+/// Returns the maximum number of elements
+size_t ring_buf_capacity(ring_buf_t* ring);
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif //RING_BUFFER_H_
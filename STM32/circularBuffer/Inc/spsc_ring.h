@@ -0,0 +1,68 @@
+#ifndef SPSC_RING_H_
+#define SPSC_RING_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+  extern "C" {
+#endif
+
+/// Lock-free single producer/single consumer ring buffer.
+/// One context (e.g. the main loop) only calls the producer functions and one other context
+/// (e.g. an interrupt) only calls the consumer functions, neither needs to mask interrupts.
+/// head is only written by the producer and tail only by the consumer. Both are free running and
+/// masked on access, so the whole capacity is usable and no full flag is shared.
+typedef struct spsc_ring_t {
+    uint8_t * buffer;
+    size_t mask;    // capacity - 1
+    size_t head;    // Free running write index, written by the producer only
+    size_t tail;    // Free running read index, written by the consumer only
+} spsc_ring_t;
+
+/// Pass in a storage buffer and size, size must be a power of two
+/// Requires: ring and buf are not NULL
+/// Returns 0 on success, -1 if size is not a power of two
+int spsc_ring_init(spsc_ring_t* ring, uint8_t* buf, size_t size);
+
+/// Producer: put up to len bytes from src
+/// Returns the number of bytes written, less than len if the ring is full
+size_t spsc_ring_write(spsc_ring_t* ring, const uint8_t* src, size_t len);
+
+/// Producer: put a single byte
+/// Returns 0 on success, -1 if the ring is full
+int spsc_ring_put(spsc_ring_t* ring, uint8_t data);
+
+/// Producer: number of bytes that can be written
+size_t spsc_ring_space(spsc_ring_t* ring);
+
+/// Consumer: retrieve up to len bytes into dst
+/// Returns the number of bytes read, less than len if the ring is empty
+size_t spsc_ring_read(spsc_ring_t* ring, uint8_t* dst, size_t len);
+
+/// Consumer: copy up to len of the oldest bytes into dst without removing them
+/// Returns the number of bytes copied
+size_t spsc_ring_peek(spsc_ring_t* ring, uint8_t* dst, size_t len);
+
+/// Consumer: discard up to len of the oldest bytes
+void spsc_ring_skip(spsc_ring_t* ring, size_t len);
+
+/// Consumer: retrieve a single byte
+/// Returns 0 on success, -1 if the ring is empty
+int spsc_ring_get(spsc_ring_t* ring, uint8_t* data);
+
+/// Consumer: discard all bytes in the ring
+void spsc_ring_flush(spsc_ring_t* ring);
+
+/// Either side: number of bytes in the ring. Exact for the consumer, a lower bound of the free
+/// space for the producer.
+size_t spsc_ring_size(spsc_ring_t* ring);
+
+/// Returns the maximum capacity of the ring
+size_t spsc_ring_capacity(spsc_ring_t* ring);
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif //SPSC_RING_H_
@@ -149,6 +149,131 @@ int circular_buf_get(cbuf_handle_t cbuf, uint8_t * data)
     return r;
 }
 
+size_t circular_buf_write(cbuf_handle_t cbuf, const uint8_t* src, size_t len)
+{
+    len = circular_buf_stage(cbuf, 0, src, len);
+    circular_buf_commit_write(cbuf, len);
+
+    return len;
+}
+
+size_t circular_buf_stage(cbuf_handle_t cbuf, size_t offset, const uint8_t* src, size_t len)
+{
+    assert(cbuf && cbuf->buffer && (src || len == 0));
+
+    size_t space = cbuf->max - circular_buf_size(cbuf);
+    if (offset >= space)
+    {
+        return 0;
+    }
+    if (len > space - offset)
+    {
+        len = space - offset;
+    }
+
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    // First segment up to the end of the storage, the rest wraps to the start
+    size_t start = (cbuf->head + offset) % cbuf->max;
+    size_t first = cbuf->max - start;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(&cbuf->buffer[start], src, first);
+    memcpy(cbuf->buffer, &src[first], len - first);
+
+    return len;
+}
+
+size_t circular_buf_read(cbuf_handle_t cbuf, uint8_t* dst, size_t len)
+{
+    assert(cbuf && cbuf->buffer && (dst || len == 0));
+
+    size_t size = circular_buf_size(cbuf);
+    if (len > size)
+    {
+        len = size;
+    }
+
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    size_t first = cbuf->max - cbuf->tail;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(dst, &cbuf->buffer[cbuf->tail], first);
+    memcpy(&dst[first], cbuf->buffer, len - first);
+
+    cbuf->tail = (cbuf->tail + len) % cbuf->max;
+    cbuf->full = false;
+
+    return len;
+}
+
+size_t circular_buf_peek_contiguous(cbuf_handle_t cbuf, const uint8_t** data)
+{
+    assert(cbuf && cbuf->buffer && data);
+
+    *data = &cbuf->buffer[cbuf->tail];
+
+    if (circular_buf_empty(cbuf))
+    {
+        return 0;
+    }
+
+    // Readable up to head, or up to the end of the storage if the data wraps
+    return (cbuf->head > cbuf->tail) ? cbuf->head - cbuf->tail : cbuf->max - cbuf->tail;
+}
+
+void circular_buf_commit_read(cbuf_handle_t cbuf, size_t len)
+{
+    assert(cbuf && len <= circular_buf_size(cbuf));
+
+    if (len == 0)
+    {
+        return;
+    }
+
+    cbuf->tail = (cbuf->tail + len) % cbuf->max;
+    cbuf->full = false;
+}
+
+size_t circular_buf_reserve(cbuf_handle_t cbuf, uint8_t** data)
+{
+    assert(cbuf && cbuf->buffer && data);
+
+    *data = &cbuf->buffer[cbuf->head];
+
+    if (circular_buf_full(cbuf))
+    {
+        return 0;
+    }
+
+    // Writable up to tail, or up to the end of the storage if the free space wraps
+    return (cbuf->tail > cbuf->head) ? cbuf->tail - cbuf->head : cbuf->max - cbuf->head;
+}
+
+void circular_buf_commit_write(cbuf_handle_t cbuf, size_t len)
+{
+    assert(cbuf && len <= circular_buf_capacity(cbuf) - circular_buf_size(cbuf));
+
+    if (len == 0)
+    {
+        return;
+    }
+
+    cbuf->head = (cbuf->head + len) % cbuf->max;
+    cbuf->full = (cbuf->head == cbuf->tail);
+}
+
 bool circular_buf_empty(cbuf_handle_t cbuf)
 {
     assert(cbuf);
@@ -0,0 +1,156 @@
+/*
+ * ring_buffer.c
+ * Ring buffer of fixed size elements. Elements are copied in at most two memcpy segments and
+ * indexes are wrapped by comparison, so any capacity is allowed.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "ring_buffer.h"
+
+//#pragma mark - Private Functions -
+
+// Copy n elements into the ring starting at element index idx (< capacity), wrapping at the end
+static void copy_in(ring_buf_t* ring, size_t idx, const uint8_t* src, size_t n)
+{
+    size_t first = ring->capacity - idx;
+    if (first > n)
+        first = n;
+
+    memcpy(&ring->buffer[idx * ring->elemSize], src, first * ring->elemSize);
+    memcpy(ring->buffer, &src[first * ring->elemSize], (n - first) * ring->elemSize);
+}
+
+// Copy n elements out of the ring starting at element index idx (< capacity), wrapping at the end
+static void copy_out(ring_buf_t* ring, size_t idx, uint8_t* dst, size_t n)
+{
+    size_t first = ring->capacity - idx;
+    if (first > n)
+        first = n;
+
+    memcpy(dst, &ring->buffer[idx * ring->elemSize], first * ring->elemSize);
+    memcpy(&dst[first * ring->elemSize], ring->buffer, (n - first) * ring->elemSize);
+}
+
+static size_t wrap(ring_buf_t* ring, size_t idx)
+{
+    return (idx >= ring->capacity) ? idx - ring->capacity : idx;
+}
+
+int ring_buf_init(ring_buf_t* ring, void* storage, size_t elemSize, size_t capacity, ring_buf_policy_t policy)
+{
+    if (!ring || !storage || elemSize == 0 || capacity == 0)
+    {
+        return -1;
+    }
+
+    ring->buffer = (uint8_t *) storage;
+    ring->elemSize = elemSize;
+    ring->capacity = capacity;
+    ring->policy = policy;
+    ring_buf_reset(ring);
+
+    return 0;
+}
+
+void ring_buf_reset(ring_buf_t* ring)
+{
+    assert(ring);
+
+    ring->head = 0;
+    ring->count = 0;
+    ring->dropped = 0;
+}
+
+size_t ring_buf_push(ring_buf_t* ring, const void* elems, size_t n)
+{
+    assert(ring && ring->buffer && (elems || n == 0));
+
+    const uint8_t *src = (const uint8_t *) elems;
+    size_t accepted = n;
+    size_t space = ring->capacity - ring->count;
+
+    if (n > space)
+    {
+        if (ring->policy == RING_BUF_REJECT_NEW)
+        {
+            ring->dropped += n - space;
+            n = space;
+            accepted = space;
+        }
+        else
+        {
+            // Only the newest capacity elements survive
+            if (n > ring->capacity)
+            {
+                ring->dropped += n - ring->capacity;
+                src = &src[(n - ring->capacity) * ring->elemSize];
+                n = ring->capacity;
+            }
+
+            // Discard the oldest to make room
+            size_t discard = n - space;
+            ring->head = wrap(ring, ring->head + discard);
+            ring->count -= discard;
+            ring->dropped += discard;
+        }
+    }
+
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    copy_in(ring, wrap(ring, ring->head + ring->count), src, n);
+    ring->count += n;
+
+    return accepted;
+}
+
+size_t ring_buf_pop(ring_buf_t* ring, void* elems, size_t n)
+{
+    assert(ring && ring->buffer && (elems || n == 0));
+
+    if (n > ring->count)
+    {
+        n = ring->count;
+    }
+
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    copy_out(ring, ring->head, (uint8_t *) elems, n);
+    ring->head = wrap(ring, ring->head + n);
+    ring->count -= n;
+
+    return n;
+}
+
+int ring_buf_peek(ring_buf_t* ring, size_t idx, void* elem)
+{
+    assert(ring && ring->buffer && elem);
+
+    if (idx >= ring->count)
+    {
+        return -1;
+    }
+
+    copy_out(ring, wrap(ring, ring->head + idx), (uint8_t *) elem, 1);
+    return 0;
+}
+
+size_t ring_buf_count(ring_buf_t* ring)
+{
+    assert(ring);
+
+    return ring->count;
+}
+
+size_t ring_buf_capacity(ring_buf_t* ring)
+{
+    assert(ring);
+
+    return ring->capacity;
+}
@@ -0,0 +1,153 @@
+/*
+ * spsc_ring.c
+ * Lock-free single producer/single consumer ring buffer, e.g. between the main loop and an
+ * interrupt. Each index is written by one side only. The release store of an index orders the
+ * data copy before it, and the acquire load of the other side's index orders it before the copy
+ * that depends on it (DMB on Cortex-M).
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "spsc_ring.h"
+
+int spsc_ring_init(spsc_ring_t* ring, uint8_t* buf, size_t size)
+{
+    assert(ring && buf);
+
+    if (size == 0 || (size & (size - 1)) != 0)
+    {
+        return -1;
+    }
+
+    ring->buffer = buf;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+
+    return 0;
+}
+
+size_t spsc_ring_write(spsc_ring_t* ring, const uint8_t* src, size_t len)
+{
+    assert(ring && (src || len == 0));
+
+    const size_t head = ring->head;     // Own index
+    const size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    const size_t space = ring->mask + 1 - (head - tail);
+    if (len > space)
+    {
+        len = space;
+    }
+
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    // First segment up to the end of the storage, the rest wraps to the start
+    const size_t offset = head & ring->mask;
+    size_t first = ring->mask + 1 - offset;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(&ring->buffer[offset], src, first);
+    memcpy(ring->buffer, &src[first], len - first);
+
+    // Publish the data to the consumer
+    __atomic_store_n(&ring->head, head + len, __ATOMIC_RELEASE);
+
+    return len;
+}
+
+int spsc_ring_put(spsc_ring_t* ring, uint8_t data)
+{
+    return (spsc_ring_write(ring, &data, 1) == 1) ? 0 : -1;
+}
+
+size_t spsc_ring_space(spsc_ring_t* ring)
+{
+    assert(ring);
+
+    return ring->mask + 1 - (ring->head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE));
+}
+
+size_t spsc_ring_peek(spsc_ring_t* ring, uint8_t* dst, size_t len)
+{
+    assert(ring && (dst || len == 0));
+
+    const size_t tail = ring->tail;     // Own index
+    const size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    const size_t size = head - tail;
+    if (len > size)
+    {
+        len = size;
+    }
+
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    const size_t offset = tail & ring->mask;
+    size_t first = ring->mask + 1 - offset;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(dst, &ring->buffer[offset], first);
+    memcpy(&dst[first], ring->buffer, len - first);
+
+    return len;
+}
+
+void spsc_ring_skip(spsc_ring_t* ring, size_t len)
+{
+    assert(ring);
+
+    const size_t tail = ring->tail;     // Own index
+    const size_t size = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail;
+    if (len > size)
+    {
+        len = size;
+    }
+
+    // Hand the space back to the producer
+    __atomic_store_n(&ring->tail, tail + len, __ATOMIC_RELEASE);
+}
+
+size_t spsc_ring_read(spsc_ring_t* ring, uint8_t* dst, size_t len)
+{
+    len = spsc_ring_peek(ring, dst, len);
+    spsc_ring_skip(ring, len);
+
+    return len;
+}
+
+int spsc_ring_get(spsc_ring_t* ring, uint8_t* data)
+{
+    assert(data);
+
+    return (spsc_ring_read(ring, data, 1) == 1) ? 0 : -1;
+}
+
+void spsc_ring_flush(spsc_ring_t* ring)
+{
+    assert(ring);
+
+    __atomic_store_n(&ring->tail, __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+size_t spsc_ring_size(spsc_ring_t* ring)
+{
+    assert(ring);
+
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+size_t spsc_ring_capacity(spsc_ring_t* ring)
+{
+    assert(ring);
+
+    return ring->mask + 1;
+}
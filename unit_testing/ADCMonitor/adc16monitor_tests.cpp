@@ -0,0 +1,298 @@
+/*!
+** @file   adc16monitor_tests.cpp
+** @date   15/10/2026
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+/* Fakes */
+#include "fake_stm32xxxx_hal.h"
+/* Real supporting units */
+
+/* The F401 device file only has ADC1 */
+static ADC_TypeDef ADC2_obj;
+static ADC_TypeDef ADC3_obj;
+#define ADC2 ((ADC_TypeDef *) &ADC2_obj)
+#define ADC3 ((ADC_TypeDef *) &ADC3_obj)
+
+/* Cortex-M7 D-cache maintenance, recorded to check ADCMonitorLoop */
+#define __DCACHE_PRESENT 1U
+static std::vector<std::pair<void*, int32_t>> invalidated;
+static void SCB_InvalidateDCache_by_Addr(void *addr, int32_t dsize)
+{
+    invalidated.push_back({ addr, dsize });
+}
+
+/* UUT */
+#include "ADC16monitor.c"
+
+using namespace std;
+
+/***************************************************************************************************
+** TEST FIXTURES
+***************************************************************************************************/
+
+class ADC16MonitorTest: public ::testing::Test 
+{
+    protected:
+        /*******************************************************************************************
+        ** METHODS
+        *******************************************************************************************/
+        ADC16MonitorTest() {}
+};
+
+/***************************************************************************************************
+** TESTS
+***************************************************************************************************/
+
+TEST_F(ADC16MonitorTest, testADCFrameStats)
+{
+    const int noOfSamples = 200;
+    const int noOfChannels = 3;
+    int32_t pData[noOfSamples*noOfChannels*2] = {0};
+
+    for (int i = 0; i < noOfSamples; i++)
+    {
+        pData[noOfChannels*i]   = i;
+        pData[noOfChannels*i+1] = 65535 - i;
+        pData[noOfChannels*i+2] = 32768 * sin(i * 0.1);
+    }
+
+    ADC_HandleTypeDef dummy = { { noOfChannels } };
+    ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+    HAL_ADC_ConvHalfCpltCallback(&dummy);
+
+    ADCChannelStat_t stats[noOfChannels];
+    ASSERT_EQ(ADCFrameStats(pData, stats), 0);
+
+    EXPECT_EQ(stats[0].count, (uint32_t) noOfSamples);
+    EXPECT_EQ(stats[0].sum, 19900);
+    EXPECT_EQ(stats[0].min, 0);
+    EXPECT_EQ(stats[0].max, noOfSamples - 1);
+    EXPECT_EQ((double) stats[0].sum / stats[0].count, ADCMean(pData, 0));
+
+    /* 16 bit samples must not overflow when squared */
+    uint64_t sumSquares = 0;
+    for (int i = 0; i < noOfSamples; i++)
+    {
+        sumSquares += (uint64_t) (65535 - i) * (65535 - i);
+    }
+    EXPECT_EQ(stats[1].sumSquares, sumSquares);
+    EXPECT_EQ(stats[1].max, 65535);
+    EXPECT_EQ(stats[1].min, 65535 - noOfSamples + 1);
+
+    int64_t sum = 0;
+    uint64_t absSum = 0;
+    for (int i = 0; i < noOfSamples; i++)
+    {
+        sum += pData[noOfChannels*i+2];
+        absSum += abs(pData[noOfChannels*i+2]);
+    }
+    EXPECT_EQ(stats[2].sum, sum);
+    EXPECT_EQ(stats[2].absSum, absSum);
+    EXPECT_LT(stats[2].min, 0);
+
+    for (int ch = 0; ch < noOfChannels; ch++)
+    {
+        EXPECT_EQ((int32_t) ADCmax(pData, ch), stats[ch].max);
+    }
+
+    /* A channel with only negative samples */
+    for (int i = 0; i < noOfSamples; i++)
+    {
+        pData[noOfChannels*i+2] = -1000 - i;
+    }
+    EXPECT_EQ((int32_t) ADCmax(pData, 2), -1000);
+
+    EXPECT_EQ(ADCFrameStats(NULL, stats), -1);
+    EXPECT_EQ(ADCFrameStats(pData, NULL), -1);
+}
+
+TEST_F(ADC16MonitorTest, testMultipleInstances)
+{
+    const int noOfSamples = 8;
+    int32_t buf1[noOfSamples*2*2];
+    int32_t buf2[noOfSamples*3*2];
+    int32_t buf3[noOfSamples*1*2];
+
+    for (int i = 0; i < noOfSamples*2*2; i++) buf1[i] = (i % 2) ? 100 : 10;
+    for (int i = 0; i < noOfSamples*3*2; i++) buf2[i] = 1000 * (i % 3);
+    for (int i = 0; i < noOfSamples*1*2; i++) buf3[i] = (i < noOfSamples) ? 7 : 9;
+
+    ADC_HandleTypeDef hadc1 = { { 2 } };
+    ADC_HandleTypeDef hadc2 = { { 3 } };
+    ADC_HandleTypeDef hadc3 = { { 1 } };
+    hadc1.Instance = ADC1;
+    hadc2.Instance = ADC2;
+    hadc3.Instance = ADC3;
+
+    ADCMonitorHandle h1 = ADCMonitorInitHandle(&hadc1, buf1, noOfSamples*2*2);
+    ADCMonitorHandle h2 = ADCMonitorInitHandle(&hadc2, buf2, noOfSamples*3*2);
+    ADCMonitorHandle h3 = ADCMonitorInitHandle(&hadc3, buf3, noOfSamples*1*2);
+    EXPECT_NE(h1, h2);
+    EXPECT_NE(h2, h3);
+    EXPECT_EQ(hadc2.dma_address, (uint32_t*) buf2);
+
+    static int calls[3];
+    static double means[3];
+    memset(calls, 0, sizeof(calls));
+
+    /* Each ADC completes its buffers independently */
+    HAL_ADC_ConvHalfCpltCallback(&hadc2);
+    HAL_ADC_ConvCpltCallback(&hadc3);
+
+    ADCMonitorLoopHandle(h1, [](int32_t *pBuffer, int noOfChannels, int noOfSamples) { calls[0]++; });
+    ADCMonitorLoopHandle(h2, [](int32_t *pBuffer, int noOfChannels, int noOfSamples) {
+        calls[1]++;
+        EXPECT_EQ(noOfChannels, 3);
+        means[1] = ADCMean(pBuffer, 2);
+    });
+    ADCMonitorLoopHandle(h3, [](int32_t *pBuffer, int noOfChannels, int noOfSamples) {
+        calls[2]++;
+        EXPECT_EQ(noOfChannels, 1);
+        means[2] = ADCMean(pBuffer, 0);
+    });
+
+    EXPECT_EQ(calls[0], 0);
+    EXPECT_EQ(calls[1], 1);
+    EXPECT_EQ(calls[2], 1);
+    EXPECT_EQ(means[1], 2000);
+    EXPECT_EQ(means[2], 9);
+
+    /* Statistics use the channel count of the ADC owning the buffer */
+    HAL_ADC_ConvHalfCpltCallback(&hadc1);
+    EXPECT_EQ(ADCMean(buf1, 0), 10);
+    EXPECT_EQ(ADCMean(buf1, 1), 100);
+    EXPECT_EQ(ADCMean(buf1, 2), 0);
+    EXPECT_EQ(ADCMean(buf2, 1), 1000);
+
+    /* No new buffers, no callbacks */
+    ADCMonitorLoopHandle(h2, [](int32_t *pBuffer, int noOfChannels, int noOfSamples) { calls[1]++; });
+    EXPECT_EQ(calls[1], 1);
+}
+
+TEST_F(ADC16MonitorTest, testFloatAndFixedPointAccuracy)
+{
+    const int noOfSamples = 257;
+    const int noOfChannels = 2;
+    const double q = 1 << ADC_Q_FRAC_BITS;
+    int32_t pData[noOfSamples*noOfChannels*2] = {0};
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> adc16(0, 65535);
+    std::uniform_int_distribution<int> bipolar(-32768, 32767);
+
+    for (int i = 0; i < noOfSamples; i++)
+    {
+        pData[i*noOfChannels]     = adc16(rng);
+        pData[i*noOfChannels + 1] = bipolar(rng);
+    }
+
+    ADC_HandleTypeDef dummy = { { noOfChannels } };
+    ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+    HAL_ADC_ConvHalfCpltCallback(&dummy);
+
+    for (int ch = 0; ch < noOfChannels; ch++)
+    {
+        double sum = 0, sumSquares = 0, absSum = 0;
+        for (int i = 0; i < noOfSamples; i++)
+        {
+            double sample = pData[i*noOfChannels + ch];
+            sum += sample;
+            sumSquares += sample * sample;
+            absSum += fabs(sample);
+        }
+        const double mean = sum / noOfSamples;
+        const double rms = sqrt(sumSquares / noOfSamples);
+        const double absMean = absSum / noOfSamples;
+
+        EXPECT_NEAR(ADCMeanF(pData, ch), mean, 1e-6 * fabs(mean) + 1e-3);
+        EXPECT_NEAR(ADCrmsF(pData, ch), rms, 1e-6 * rms);
+        EXPECT_NEAR(ADCAbsMeanF(pData, ch), absMean, 1e-6 * absMean);
+        EXPECT_NEAR(ADCMeanQ(pData, ch) / q, mean, 1 / q);
+        EXPECT_NEAR(ADCrmsQ(pData, ch) / q, rms, 1 / q);
+        EXPECT_NEAR(ADCAbsMeanQ(pData, ch) / q, absMean, 1 / q);
+    }
+
+    EXPECT_EQ(ADCrmsQ(pData, noOfChannels), 0);
+}
+
+static std::vector<std::pair<void*, int32_t>> invalidatedBeforeCallback;
+
+TEST_F(ADC16MonitorTest, testDCacheInvalidation)
+{
+    const int noOfSamples = 16;
+    const int noOfChannels = 2;
+    static ADC_DMA_BUFFER(pData, noOfSamples*noOfChannels*2);
+
+    EXPECT_EQ((uintptr_t) pData % ADC_CACHE_LINE, 0u);
+    EXPECT_EQ(ADC_DMA_CACHE_WORDS(noOfSamples*noOfChannels*2), noOfSamples*noOfChannels*2);
+    EXPECT_EQ(ADC_DMA_CACHE_WORDS(9), 16u);
+
+    ADC_HandleTypeDef dummy = { { noOfChannels } };
+    dummy.Instance = ADC1;
+    ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+
+    invalidated.clear();
+    HAL_ADC_ConvCpltCallback(&dummy);
+    ADCMonitorLoop([](int32_t *pBuffer, int noOfChannels, int noOfSamples) {
+        invalidatedBeforeCallback = invalidated;
+    });
+
+    /* The finished half is invalidated before the callback reads it and after it may have altered it */
+    const std::pair<void*, int32_t> secondHalf = { &pData[noOfSamples*noOfChannels], noOfSamples*noOfChannels*4 };
+    ASSERT_EQ(invalidatedBeforeCallback.size(), 1u);
+    EXPECT_EQ(invalidatedBeforeCallback[0], secondHalf);
+    ASSERT_EQ(invalidated.size(), 2u);
+    EXPECT_EQ(invalidated[1], secondHalf);
+
+    /* No new buffer, no maintenance */
+    ADCMonitorLoop([](int32_t *pBuffer, int noOfChannels, int noOfSamples) {});
+    EXPECT_EQ(invalidated.size(), 2u);
+}
+
+static ADCBufferInfo_t lastInfo;
+
+TEST_F(ADC16MonitorTest, testTimestamps)
+{
+    const int noOfSamples = 8;
+    int32_t pData[noOfSamples*2] = {0};
+
+    ADC_HandleTypeDef dummy = { { 1 } };
+    dummy.Instance = ADC1;
+    ADCMonitorHandle handle = ADCMonitorInitHandle(&dummy, pData, noOfSamples*2);
+    EXPECT_TRUE(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk);
+
+    ADCCallBackEx callback = [](int32_t *pBuffer, int noOfChannels, int noOfSamples, const ADCBufferInfo_t *info) {
+        lastInfo = *info;
+    };
+
+    DWT->CYCCNT = 0xFFFFFF00;
+    HAL_ADC_ConvHalfCpltCallback(&dummy);
+    ADCMonitorLoopHandleEx(handle, callback);
+    EXPECT_EQ(lastInfo.sequence, 1u);
+    EXPECT_EQ(lastInfo.timestamp, 0xFFFFFF00u);
+
+    DWT->CYCCNT = 0x300;
+    HAL_ADC_ConvCpltCallback(&dummy);
+    ADCMonitorLoopHandleEx(handle, callback);
+    EXPECT_EQ(lastInfo.sequence, 2u);
+    EXPECT_EQ(lastInfo.timestamp, 0x100000300u);
+
+    DWT->CYCCNT = 0x500;
+    HAL_ADC_ConvHalfCpltCallback(&dummy);
+    ADCMonitorLoopHandleEx(handle, callback);
+
+    uint32_t minPeriod, maxPeriod;
+    ADCMonitorGetJitter(handle, &minPeriod, &maxPeriod);
+    EXPECT_EQ(minPeriod, 0x200u);
+    EXPECT_EQ(maxPeriod, 0x400u);
+
+    ADCMonitorResetJitter(handle);
+    ADCMonitorGetJitter(handle, &minPeriod, &maxPeriod);
+    EXPECT_EQ(minPeriod, UINT32_MAX);
+    EXPECT_EQ(maxPeriod, 0u);
+}
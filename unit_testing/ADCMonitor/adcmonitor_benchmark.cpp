@@ -0,0 +1,107 @@
+/*!
+** @file   adcmonitor_benchmark.cpp
+** @brief  Host benchmark of the per channel statistics against the whole frame sweep
+** @date   15/10/2026
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+/* Fakes */
+#include "fake_stm32xxxx_hal.h"
+/* Real supporting units */
+
+/* UUT */
+#include "ADCmonitor.c"
+
+using namespace std;
+using namespace std::chrono;
+
+/***************************************************************************************************
+** TEST FIXTURES
+***************************************************************************************************/
+
+class ADCMonitorBenchmark: public ::testing::Test 
+{
+    protected:
+        /*******************************************************************************************
+        ** MEMBERS
+        *******************************************************************************************/
+        static const int noOfSamples  = 512;
+        static const int noOfChannels = 8;
+        static const int repetitions  = 2000;
+
+        int16_t pData[noOfSamples*noOfChannels*2];
+
+        /*******************************************************************************************
+        ** METHODS
+        *******************************************************************************************/
+        ADCMonitorBenchmark()
+        {
+            for (int i = 0; i < noOfSamples*noOfChannels*2; i++)
+            {
+                pData[i] = 2047 + 2000 * sin(i * 0.01 + (i % noOfChannels));
+            }
+
+            ADC_HandleTypeDef dummy = { { noOfChannels } };
+            ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+            HAL_ADC_ConvHalfCpltCallback(&dummy);
+        }
+
+        /* Runs the function a number of times and returns the average time per call in ns */
+        template<typename F>
+        static double timeIt(F func)
+        {
+            auto begin = steady_clock::now();
+            for (int i = 0; i < repetitions; i++)
+            {
+                func();
+            }
+            auto end = steady_clock::now();
+            return duration_cast<nanoseconds>(end - begin).count() / (double) repetitions;
+        }
+};
+
+/***************************************************************************************************
+** TESTS
+***************************************************************************************************/
+
+TEST_F(ADCMonitorBenchmark, benchmarkFrameStats)
+{
+    /* Volatile sink prevents the compiler from removing the loops */
+    volatile double sink = 0;
+    ADCChannelStat_t stats[noOfChannels];
+
+    /* Mean, rms, abs mean, min and max of every channel using the per channel functions */
+    double perFunction = timeIt([&]() {
+        for (int ch = 0; ch < noOfChannels; ch++)
+        {
+            sink = sink + ADCMean(pData, ch) + ADCrms(pData, ch) + ADCAbsMean(pData, ch)
+                        + ADCmax(pData, ch) + ADCmin(pData, ch);
+        }
+    });
+
+    /* Same statistics with one strided pass per channel */
+    double perChannel = timeIt([&]() {
+        for (int ch = 0; ch < noOfChannels; ch++)
+        {
+            ADCChannelStats(pData, ch, &stats[ch]);
+        }
+        sink = sink + stats[0].sum;
+    });
+
+    /* Same statistics with one sequential pass for all channels */
+    double frame = timeIt([&]() {
+        ADCFrameStats(pData, stats);
+        sink = sink + stats[0].sum;
+    });
+
+    /* Timings are only reported, they are too noisy on shared CI runners to assert on */
+    printf("%d channels x %d samples\r\n", noOfChannels, noOfSamples);
+    printf("  Per statistic functions: %10.0f ns\r\n", perFunction);
+    printf("  ADCChannelStats loop:    %10.0f ns (%.1fx)\r\n", perChannel, perFunction / perChannel);
+    printf("  ADCFrameStats:           %10.0f ns (%.1fx)\r\n", frame, perFunction / frame);
+}
@@ -7,6 +7,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <cmath>
+#include <random>
 
 /* Fakes */
 #include "fake_stm32xxxx_hal.h"
@@ -22,6 +23,31 @@ using ::testing::ElementsAre;
 using ::testing::IsEmpty;
 using namespace std;
 
+/***************************************************************************************************
+** HELPER FUNCTIONS
+***************************************************************************************************/
+
+/* Portable one sample at a time version of sumsKernel */
+static void sumsReference(const int16_t* pData, uint32_t stride, uint32_t count, ADCChannelStat_t* stats)
+{
+    int64_t  sum        = 0;
+    uint64_t sumSquares = 0;
+    uint64_t absSum     = 0;
+
+    for (uint32_t sampleId = 0; sampleId < count; sampleId++)
+    {
+        const int32_t sample = pData[sampleId*stride];
+        sum        += sample;
+        sumSquares += (uint32_t) (sample * sample);
+        absSum     += (uint32_t) abs(sample);
+    }
+
+    stats->sum        = sum;
+    stats->sumSquares = sumSquares;
+    stats->absSum     = absSum;
+    stats->count      = count;
+}
+
 /***************************************************************************************************
 ** TEST FIXTURES
 ***************************************************************************************************/
@@ -57,6 +83,147 @@ class ADCMonitorTest: public ::testing::Test
 ** TESTS
 ***************************************************************************************************/
 
+TEST_F(ADCMonitorTest, testADCChannelStats)
+{
+    const int noOfSamples = 1000;
+    const int noOfChannels = 3;
+    int16_t pData[noOfSamples*noOfChannels*2] = {0};
+
+    for (int i = 0; i<noOfSamples; i++)
+    {
+        pData[noOfChannels*i] = i - 500;
+    }
+    generateSine(pData, noOfChannels, noOfSamples, 1, 2047, 2047, 1000);
+    generateSine(pData, noOfChannels, noOfSamples, 2, 0, 1023, 1000);
+
+    ADCChannelStat_t stats;
+    ADC_HandleTypeDef dummy = { { noOfChannels } };
+    ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+    HAL_ADC_ConvHalfCpltCallback(&dummy);
+
+    /* The single pass statistics must match the individual statistics functions */
+    for (int ch = 0; ch < noOfChannels; ch++)
+    {
+        ASSERT_EQ(ADCChannelStats(pData, ch, &stats), 0);
+        EXPECT_EQ(stats.count, (uint32_t) noOfSamples);
+        EXPECT_EQ(stats.min, ADCmin(pData, ch));
+        EXPECT_EQ(stats.max, ADCmax(pData, ch));
+        EXPECT_EQ(((double) stats.sum) / stats.count, ADCMean(pData, ch));
+        EXPECT_EQ(((double) stats.absSum) / stats.count, ADCAbsMean(pData, ch));
+        EXPECT_EQ(sqrt(((double) stats.sumSquares) / stats.count), ADCrms(pData, ch));
+    }
+
+    /* Negative samples are summed as signed values */
+    ASSERT_EQ(ADCChannelStats(pData, 0, &stats), 0);
+    EXPECT_EQ(stats.sum, -500);
+    EXPECT_EQ(stats.absSum, 250000u);
+    EXPECT_EQ(stats.min, -500);
+    EXPECT_EQ(stats.max, 499);
+    EXPECT_EQ(ADCMean(pData, 0), -0.5);
+
+    /* Invalid input */
+    EXPECT_EQ(ADCChannelStats(pData, noOfChannels, &stats), -1);
+    EXPECT_EQ(stats.count, 0u);
+    EXPECT_EQ(ADCChannelStats(NULL, 0, &stats), -1);
+    EXPECT_EQ(ADCChannelStats(pData, 0, NULL), -1);
+}
+
+TEST_F(ADCMonitorTest, testADCFrameStats)
+{
+    const int noOfSamples = 500;
+    const int noOfChannels = 4;
+    int16_t pData[noOfSamples*noOfChannels*2] = {0};
+
+    generate4Sines(pData, noOfSamples, 0, 10);
+    for (int i = 0; i<noOfSamples; i++)
+    {
+        pData[4*i+3] = 250 - i;
+    }
+
+    ADCChannelStat_t frame[noOfChannels];
+    ADCChannelStat_t single;
+    ADC_HandleTypeDef dummy = { { noOfChannels } };
+    ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+    HAL_ADC_ConvHalfCpltCallback(&dummy);
+
+    ASSERT_EQ(ADCFrameStats(pData, frame), 0);
+    for (int ch = 0; ch < noOfChannels; ch++)
+    {
+        ASSERT_EQ(ADCChannelStats(pData, ch, &single), 0);
+        EXPECT_EQ(frame[ch].sum, single.sum);
+        EXPECT_EQ(frame[ch].sumSquares, single.sumSquares);
+        EXPECT_EQ(frame[ch].absSum, single.absSum);
+        EXPECT_EQ(frame[ch].min, single.min);
+        EXPECT_EQ(frame[ch].max, single.max);
+        EXPECT_EQ(frame[ch].count, single.count);
+    }
+    EXPECT_EQ(frame[3].min, -249);
+    EXPECT_EQ(frame[3].max, 250);
+
+    /* Second half of the buffer */
+    HAL_ADC_ConvCpltCallback(&dummy);
+    ASSERT_EQ(ADCFrameStats(&pData[noOfSamples*noOfChannels], frame), 0);
+    for (int ch = 0; ch < noOfChannels; ch++)
+    {
+        EXPECT_EQ(frame[ch].sum, 0);
+        EXPECT_EQ(frame[ch].max, 0);
+    }
+
+    EXPECT_EQ(ADCFrameStats(NULL, frame), -1);
+    EXPECT_EQ(ADCFrameStats(pData, NULL), -1);
+}
+
+TEST_F(ADCMonitorTest, testSumsKernelBitExact)
+{
+    const int length = 4097;
+    int16_t pData[length];
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(INT16_MIN, INT16_MAX);
+    for (int i = 0; i < length; i++)
+    {
+        pData[i] = dist(gen);
+    }
+
+    /* Extreme values must be handled exactly, including abs(-32768) */
+    pData[0] = INT16_MIN;
+    pData[1] = INT16_MAX;
+    pData[2] = INT16_MIN;
+    pData[3] = -1;
+
+    for (uint32_t stride = 1; stride <= 5; stride++)
+    {
+        for (uint32_t count : { 0u, 1u, 2u, 3u, 100u, 101u, (length - 1) / stride })
+        {
+            ADCChannelStat_t kernel, reference;
+            sumsKernel(pData, stride, count, &kernel);
+            sumsReference(pData, stride, count, &reference);
+
+            EXPECT_EQ(kernel.sum, reference.sum) << "stride " << stride << " count " << count;
+            EXPECT_EQ(kernel.sumSquares, reference.sumSquares) << "stride " << stride << " count " << count;
+            EXPECT_EQ(kernel.absSum, reference.absSum) << "stride " << stride << " count " << count;
+            EXPECT_EQ(kernel.count, reference.count);
+        }
+    }
+
+    /* Sign of each halfword, independent of the other */
+    for (int32_t lo : { 0, 1, 32767, -1, -32768 })
+    {
+        for (int32_t hi : { 0, 1, 32767, -1, -32768 })
+        {
+            uint32_t sign = DSP_SIGN16(DSP_PACK(lo, hi));
+            EXPECT_EQ((int16_t) sign, (lo < 0) ? -1 : 1) << lo << " " << hi;
+            EXPECT_EQ((int16_t) (sign >> 16), (hi < 0) ? -1 : 1) << lo << " " << hi;
+        }
+    }
+
+    ADCChannelStat_t stats;
+    sumsKernel(pData, 1, 4, &stats);
+    EXPECT_EQ(stats.sum, -32768 + 32767 - 32768 - 1);
+    EXPECT_EQ(stats.absSum, 32768u + 32767u + 32768u + 1u);
+    EXPECT_EQ(stats.sumSquares, 2u*32768u*32768u + 32767u*32767u + 1u);
+}
+
 TEST_F(ADCMonitorTest, testADCMean)
 {
     const int noOfSamples = 100;
@@ -306,4 +473,552 @@ TEST_F(ADCMonitorTest, testSine)
     s = sineWave(pData, 4, noOfSamples, 2);
     EXPECT_EQ(s.begin, 3);
     EXPECT_EQ(s.end, 111);
-}
\ No newline at end of file
+}
+TEST_F(ADCMonitorTest, testADCMonitorLoopTelemetry)
+{
+    const int noOfSamples = 10;
+    const int noOfChannels = 2;
+    int16_t pData[noOfSamples*noOfChannels*2] = {0};
+
+    static ADC_HandleTypeDef dummy = { { noOfChannels } };
+    static int calls;
+    static int16_t* lastBuffer;
+    static uint32_t callbackCycles;
+    static bool triggerIsr;
+    calls = 0;
+    callbackCycles = 0;
+    triggerIsr = false;
+
+    ADCCallBack callback = [](int16_t *pBuffer, int noOfChannels, int noOfSamples) {
+        calls++;
+        lastBuffer = pBuffer;
+        DWT->CYCCNT += callbackCycles;
+        if (triggerIsr)
+        {
+            HAL_ADC_ConvHalfCpltCallback(&dummy);
+        }
+    };
+
+    ADCMonitorTelemetry_t telemetry;
+    DWT->CYCCNT = 0;
+    ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+    EXPECT_TRUE(CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk);
+    EXPECT_TRUE(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk);
+
+    /* Nothing happens until the first half buffer is ready */
+    ADCMonitorLoop(callback);
+    EXPECT_EQ(calls, 0);
+
+    HAL_ADC_ConvHalfCpltCallback(&dummy);
+    ADCMonitorLoop(callback);
+    ADCMonitorLoop(callback);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(lastBuffer, pData);
+
+    /* A half buffer period of 1000 cycles and a callback taking 250 cycles */
+    DWT->CYCCNT = 1000;
+    callbackCycles = 250;
+    HAL_ADC_ConvCpltCallback(&dummy);
+    ADCMonitorLoop(callback);
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(lastBuffer, &pData[noOfSamples*noOfChannels]);
+
+    ADCMonitorGetTelemetry(&telemetry);
+    EXPECT_EQ(telemetry.sequence, 2u);
+    EXPECT_EQ(telemetry.dropped, 0u);
+    EXPECT_EQ(telemetry.overruns, 0u);
+    EXPECT_EQ(telemetry.periodCycles, 1000u);
+    EXPECT_EQ(telemetry.callbackCycles, 250u);
+    EXPECT_EQ(telemetry.loadPermille, 250u);
+
+    /* Main loop too slow, two half buffers are never processed */
+    HAL_ADC_ConvHalfCpltCallback(&dummy);
+    HAL_ADC_ConvCpltCallback(&dummy);
+    HAL_ADC_ConvHalfCpltCallback(&dummy);
+    callbackCycles = 100;
+    ADCMonitorLoop(callback);
+    EXPECT_EQ(calls, 3);
+    EXPECT_EQ(lastBuffer, pData);
+    ADCMonitorGetTelemetry(&telemetry);
+    EXPECT_EQ(telemetry.sequence, 5u);
+    EXPECT_EQ(telemetry.dropped, 2u);
+
+    /* The DMA completes the next half buffer while the callback is running */
+    DWT->CYCCNT = 2000;
+    HAL_ADC_ConvCpltCallback(&dummy);
+    callbackCycles = 1000;
+    triggerIsr = true;
+    ADCMonitorLoop(callback);
+    ADCMonitorGetTelemetry(&telemetry);
+    EXPECT_EQ(telemetry.overruns, 1u);
+    EXPECT_EQ(telemetry.periodCycles, 1000u);
+    EXPECT_EQ(telemetry.loadPermille, 1000u);
+    EXPECT_EQ(telemetry.maxLoadPermille, 1000u);
+    EXPECT_STREQ(ADCMonitorStatus(), "ADC buffers: 7, dropped: 2, overruns: 1, load: 100.0% (max 100.0%)\r\n");
+
+    ADCMonitorResetTelemetry();
+    ADCMonitorGetTelemetry(&telemetry);
+    EXPECT_EQ(telemetry.sequence, 7u);
+    EXPECT_EQ(telemetry.dropped, 0u);
+    EXPECT_EQ(telemetry.overruns, 0u);
+    EXPECT_EQ(telemetry.maxLoadPermille, 0u);
+}
+
+TEST_F(ADCMonitorTest, testADCDeinterleave)
+{
+    const int noOfSamples = 70;
+    const int noOfChannels = 3;
+    int16_t pData[noOfSamples*noOfChannels*2];
+    int16_t planar[noOfSamples*noOfChannels];
+
+    for (int i = 0; i < noOfSamples*noOfChannels*2; i++)
+    {
+        /* Sample number in the upper part, channel in the lower part, offset for second half */
+        pData[i] = (i / noOfChannels) * 10 + (i % noOfChannels);
+    }
+
+    ADC_HandleTypeDef dummy = { { noOfChannels } };
+    ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+
+    ASSERT_EQ(ADCDeinterleave(pData, planar), 0);
+    for (int ch = 0; ch < noOfChannels; ch++)
+    {
+        for (int i = 0; i < noOfSamples; i++)
+        {
+            ASSERT_EQ(planar[ch*noOfSamples + i], i*10 + ch);
+        }
+    }
+    EXPECT_EQ(ADCDeinterleave(NULL, planar), -1);
+    EXPECT_EQ(ADCDeinterleave(pData, NULL), -1);
+
+    /* As a stage of ADCMonitorLoop */
+    EXPECT_EQ(ADCChannelSlice(0), nullptr);
+    memset(planar, 0, sizeof(planar));
+    ADCMonitorSetPlanarBuffer(planar);
+    EXPECT_EQ(ADCChannelSlice(noOfChannels), nullptr);
+
+    HAL_ADC_ConvCpltCallback(&dummy);
+    ADCMonitorLoop([](int16_t *pBuffer, int noOfChannels, int noOfSamples) {
+        for (int ch = 0; ch < noOfChannels; ch++)
+        {
+            const int16_t* slice = ADCChannelSlice(ch);
+            ASSERT_NE(slice, nullptr);
+            for (int i = 0; i < noOfSamples; i++)
+            {
+                ASSERT_EQ(slice[i], pBuffer[i*noOfChannels + ch]);
+            }
+        }
+    });
+    EXPECT_EQ(ADCChannelSlice(2)[0], noOfSamples*10 + 2);
+
+    /* Single channel is a plain copy */
+    ADC_HandleTypeDef single = { { 1 } };
+    ADCMonitorInit(&single, pData, 20);
+    ASSERT_EQ(ADCDeinterleave(pData, planar), 0);
+    EXPECT_EQ(memcmp(pData, planar, 10*sizeof(int16_t)), 0);
+}
+
+TEST_F(ADCMonitorTest, testADCZeroCross)
+{
+    const int noOfSamples = 100;
+    const int noOfChannels = 2;
+    const float sampleRate = 1875.0; // 37.5 samples per period at 50 Hz
+    int16_t pData[noOfSamples*noOfChannels*2];
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> noise(-30, 30);
+
+    ADC_HandleTypeDef dummy = { { noOfChannels } };
+    ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+
+    ADCZeroCross_t zc0, zc1;
+    ADCZeroCrossInit(&zc0, 2048, 200);
+    ADCZeroCrossInit(&zc1, 2048, 200);
+    EXPECT_EQ(ADCZeroCrossFrequency(&zc0, sampleRate), 0);
+
+    int totalCrossings = 0;
+    for (int buffer = 0; buffer < 20; buffer++)
+    {
+        int16_t* pBuffer = &pData[(buffer % 2) * noOfSamples * noOfChannels];
+        for (int i = 0; i < noOfSamples; i++)
+        {
+            double t = (buffer * noOfSamples + i) / sampleRate;
+            pBuffer[i*noOfChannels]     = 2048 + 1000 * sin(2*M_PI*50*t) + noise(rng);
+            pBuffer[i*noOfChannels + 1] = 2048 + 1000 * sin(2*M_PI*50*t - M_PI/2) + noise(rng);
+        }
+        (buffer % 2) ? HAL_ADC_ConvCpltCallback(&dummy) : HAL_ADC_ConvHalfCpltCallback(&dummy);
+
+        SineWaveIndexes_t indexes;
+        int crossings = ADCZeroCrossUpdate(&zc0, pBuffer, 0, &indexes);
+        ASSERT_GE(crossings, 2);
+        ASSERT_LE(crossings, 3);
+        totalCrossings += crossings;
+        ASSERT_GE(ADCZeroCrossUpdate(&zc1, pBuffer, 1, NULL), 2);
+
+        // The window holds a whole number of periods, i.e. the true RMS is not biased
+        int periods = crossings - 1;
+        EXPECT_NEAR(indexes.end - indexes.begin + 1, periods * 37.5, 1);
+        EXPECT_NEAR(ADCTrueRms(pBuffer, 0, indexes), sqrt(2048.0*2048.0 + 1000.0*1000.0/2), 15);
+        EXPECT_NEAR(ADCMeanLimited(pBuffer, 0, indexes), 2048, 15);
+
+        if (buffer > 0)
+        {
+            EXPECT_NEAR(zc0.period, 37.5, 0.5);
+            EXPECT_NEAR(ADCZeroCrossFrequency(&zc0, sampleRate), 50, 0.7);
+
+            // Channel 1 lags a quarter of a period
+            float diff = zc0.phase - zc1.phase - 0.25;
+            EXPECT_NEAR(diff - roundf(diff), 0, 0.02);
+
+            // Phase at the first sample of the buffer
+            float error = zc0.phase - fmod(buffer * noOfSamples / 37.5, 1.0);
+            EXPECT_NEAR(error - roundf(error), 0, 0.02);
+        }
+    }
+    EXPECT_EQ(zc0.cycles, totalCrossings - 1);
+
+    // Flat signal, the period is lost after two periods without crossings
+    for (int i = 0; i < noOfSamples*noOfChannels; i++)
+        pData[i] = 2048;
+    HAL_ADC_ConvHalfCpltCallback(&dummy);
+    EXPECT_EQ(ADCZeroCrossUpdate(&zc0, pData, 0, NULL), 0);
+    EXPECT_EQ(ADCZeroCrossFrequency(&zc0, sampleRate), 0);
+
+    EXPECT_EQ(ADCZeroCrossUpdate(NULL, pData, 0, NULL), -1);
+    EXPECT_EQ(ADCZeroCrossUpdate(&zc0, pData, noOfChannels, NULL), -1);
+}
+
+TEST_F(ADCMonitorTest, testADCZeroCrossLongPeriod)
+{
+    /* Periods longer than a half buffer, so most half buffers hold no crossing */
+    const int noOfSamples = 100;
+    const int noOfChannels = 1;
+    int16_t pData[noOfSamples*noOfChannels*2];
+
+    ADC_HandleTypeDef dummy = { { noOfChannels } };
+    ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+
+    for (double period : { 150.0, 250.0, 1000.0 })
+    {
+        ADCZeroCross_t zc;
+        ADCZeroCrossInit(&zc, 2048, 200);
+
+        for (int buffer = 0; buffer < 40; buffer++)
+        {
+            int16_t* pBuffer = &pData[(buffer % 2) * noOfSamples];
+            for (int i = 0; i < noOfSamples; i++)
+            {
+                double t = buffer * noOfSamples + i;
+                pBuffer[i] = lround(2048 + 1000 * sin(2*M_PI*t/period + 0.3));
+            }
+            (buffer % 2) ? HAL_ADC_ConvCpltCallback(&dummy) : HAL_ADC_ConvHalfCpltCallback(&dummy);
+            ASSERT_GE(ADCZeroCrossUpdate(&zc, pBuffer, 0, NULL), 0);
+        }
+        EXPECT_TRUE(zc.locked) << period;
+        EXPECT_NEAR(zc.period, period, 0.5) << period;
+        EXPECT_NEAR(ADCZeroCrossFrequency(&zc, 10000.0), 10000.0 / period, 0.1) << period;
+    }
+
+    /* A single crossing is dropped after maxPeriod samples without another one */
+    ADCZeroCross_t zc;
+    ADCZeroCrossInit(&zc, 2048, 200);
+    zc.maxPeriod = 300;
+    for (int buffer = 0; buffer < 5; buffer++)
+    {
+        int16_t* pBuffer = &pData[(buffer % 2) * noOfSamples];
+        for (int i = 0; i < noOfSamples; i++)
+            pBuffer[i] = (buffer == 0 && i < 50) ? 0 : 4000;
+        (buffer % 2) ? HAL_ADC_ConvCpltCallback(&dummy) : HAL_ADC_ConvHalfCpltCallback(&dummy);
+        ADCZeroCrossUpdate(&zc, pBuffer, 0, NULL);
+        EXPECT_EQ(zc.locked, buffer < 3) << buffer;
+    }
+    EXPECT_EQ(zc.period, 0);
+}
+
+TEST_F(ADCMonitorTest, testADCCycleRms)
+{
+    const int noOfSamples = 100;
+    const int noOfChannels = 2;
+    const double period = 37.5;
+    int16_t pData[noOfSamples*noOfChannels*2];
+
+    ADC_HandleTypeDef dummy = { { noOfChannels } };
+    ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+
+    ADCCycleRms_t acc;
+    ADCCycleRmsInit(&acc, 2048, 200, 4);
+
+    int results = 0;
+    for (int buffer = 0; buffer < 30; buffer++)
+    {
+        int16_t* pBuffer = &pData[(buffer % 2) * noOfSamples * noOfChannels];
+        for (int i = 0; i < noOfSamples; i++)
+        {
+            double t = buffer * noOfSamples + i;
+            pBuffer[i*noOfChannels]     = 1;
+            pBuffer[i*noOfChannels + 1] = lround(2048 + 1000 * sin(2*M_PI*t/period));
+        }
+        (buffer % 2) ? HAL_ADC_ConvCpltCallback(&dummy) : HAL_ADC_ConvHalfCpltCallback(&dummy);
+
+        uint32_t previousResults = acc.results;
+        int completed = ADCCycleRmsUpdate(&acc, pBuffer, 1);
+        ASSERT_GE(completed, 0);
+        ASSERT_LE(completed, 1);
+        ASSERT_EQ(acc.results, previousResults + completed);
+        results += completed;
+
+        if (completed)
+        {
+            // Whole cycles only, so no ripple regardless of where the half buffers start
+            EXPECT_NEAR(acc.rms, sqrt(2048.0*2048.0 + 1000.0*1000.0/2), 0.5);
+            EXPECT_NEAR(acc.mean, 2048, 0.5);
+        }
+    }
+    // 3000 samples hold 80 cycles, the first (partial) one is discarded
+    EXPECT_EQ(results, 19);
+    EXPECT_EQ(ADCCycleRmsUpdate(NULL, pData, 1), -1);
+    EXPECT_EQ(ADCCycleRmsUpdate(&acc, pData, noOfChannels), -1);
+}
+
+TEST_F(ADCMonitorTest, testADCCycleRmsSignalLost)
+{
+    const int noOfSamples = 100;
+    const int noOfChannels = 1;
+    const double period = 37.5;
+    int16_t pData[noOfSamples*noOfChannels*2];
+
+    ADC_HandleTypeDef dummy = { { noOfChannels } };
+    ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+
+    ADCCycleRms_t acc;
+    ADCCycleRmsInit(&acc, 2048, 200, 4);
+
+    // Sine burst, a flat gap far longer than two periods and another burst with a different
+    // amplitude. A result spanning the gap would include the flat samples.
+    bool firstAfterGap = true;
+    for (int buffer = 0; buffer < 40; buffer++)
+    {
+        const bool gap = buffer >= 10 && buffer < 20;
+        const double amplitude = (buffer < 10) ? 1000 : 500;
+        int16_t* pBuffer = &pData[(buffer % 2) * noOfSamples];
+        for (int i = 0; i < noOfSamples; i++)
+        {
+            double t = buffer * noOfSamples + i;
+            pBuffer[i] = gap ? 2048 : lround(2048 + amplitude * sin(2*M_PI*t/period));
+        }
+        (buffer % 2) ? HAL_ADC_ConvCpltCallback(&dummy) : HAL_ADC_ConvHalfCpltCallback(&dummy);
+
+        int completed = ADCCycleRmsUpdate(&acc, pBuffer, 0);
+        ASSERT_GE(completed, 0);
+
+        if (buffer == 9)
+        {
+            EXPECT_TRUE(acc.zc.locked);
+            EXPECT_NEAR(acc.zc.period, period, 0.5);
+            EXPECT_NEAR(ADCZeroCrossFrequency(&acc.zc, 10000.0), 10000.0 / period, 0.2);
+        }
+        if (gap)
+        {
+            EXPECT_EQ(completed, 0);
+            if (buffer > 10)
+            {
+                EXPECT_FALSE(acc.zc.locked);
+                EXPECT_EQ(acc.zc.period, 0);
+                EXPECT_EQ(acc.count, 0u);
+                EXPECT_EQ(acc.cycles, 0);
+            }
+        }
+        if (buffer >= 20 && completed && firstAfterGap)
+        {
+            // Whole cycles of the second burst only
+            EXPECT_NEAR(acc.rms, sqrt(2048.0*2048.0 + 500.0*500.0/2), 0.5);
+            EXPECT_NEAR(acc.mean, 2048, 0.5);
+            firstAfterGap = false;
+        }
+    }
+    EXPECT_FALSE(firstAfterGap);
+}
+
+static int decimatedCallbacks;
+static int16_t decimatedMean[2];
+
+TEST_F(ADCMonitorTest, testADCMonitorDecimation)
+{
+    const int noOfSamples = 40;
+    const int noOfChannels = 2;
+    int16_t pData[noOfSamples*noOfChannels*2];
+    int16_t pDecimated[noOfSamples*noOfChannels];
+
+    // 10 kHz per channel, factor 4, 62.5 callbacks per second gives the same half buffer size
+    EXPECT_EQ(ADC_DECIMATION_DMA_LENGTH(noOfChannels, 10000, 4, 62.5), noOfSamples*noOfChannels*2);
+    // 10000 / (4 * 60) = 41.7 samples, rounded up to a multiple of the factor
+    EXPECT_EQ(ADC_DECIMATION_DMA_LENGTH(noOfChannels, 10000, 4, 60), 44*noOfChannels*2);
+    EXPECT_EQ(ADC_DECIMATION_DMA_LENGTH(3, 48000, 16, 100), 32*3*2);
+
+    ADC_HandleTypeDef dummy = { { noOfChannels } };
+    ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+    EXPECT_EQ(ADCMonitorSetDecimation(3, 0, pDecimated), -1);
+    EXPECT_EQ(ADCMonitorSetDecimation(4, 0, NULL), -1);
+
+    // The decimation sums are sized for ADC_MAX_CHANNELS
+    int16_t pWide[(ADC_MAX_CHANNELS+1)*4*2];
+    ADC_HandleTypeDef wide = { { ADC_MAX_CHANNELS+1 } };
+    ADCMonitorInit(&wide, pWide, sizeof(pWide)/sizeof(pWide[0]));
+    EXPECT_EQ(ADCMonitorSetDecimation(4, 0, pDecimated), -1);
+
+    ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+    ASSERT_EQ(ADCMonitorSetDecimation(4, 1, pDecimated), 0);
+
+    auto callback = [](int16_t *pBuffer, int noOfChannels, int noOfSamples) {
+        decimatedCallbacks++;
+        ASSERT_EQ(noOfSamples, 40);
+        // Each decimated sample is the sum of 4 samples shifted once, i.e. twice the mean
+        for (int i = 0; i < noOfSamples; i++)
+        {
+            int first = i * 4;
+            int expected = ((first + first+1 + first+2 + first+3) * 10) >> 1;
+            ASSERT_EQ(pBuffer[i*noOfChannels], expected);
+            ASSERT_EQ(pBuffer[i*noOfChannels + 1], -4*100 >> 1);
+        }
+        decimatedMean[0] = ADCMean(pBuffer, 0);
+        decimatedMean[1] = ADCMean(pBuffer, 1);
+    };
+
+    decimatedCallbacks = 0;
+    for (int buffer = 0; buffer < 8; buffer++)
+    {
+        int16_t* pBuffer = &pData[(buffer % 2) * noOfSamples * noOfChannels];
+        for (int i = 0; i < noOfSamples; i++)
+        {
+            // Ramp continuing over the 4 half buffers of a decimated frame
+            pBuffer[i*noOfChannels]     = ((buffer % 4) * noOfSamples + i) * 10;
+            pBuffer[i*noOfChannels + 1] = -100;
+        }
+        (buffer % 2) ? HAL_ADC_ConvCpltCallback(&dummy) : HAL_ADC_ConvHalfCpltCallback(&dummy);
+        ADCMonitorLoop(callback);
+        EXPECT_EQ(decimatedCallbacks, (buffer + 1) / 4);
+    }
+    EXPECT_EQ(decimatedMean[0], 1590);
+    EXPECT_EQ(decimatedMean[1], -200);
+
+    // Saturation of the shifted sum
+    pData[0] = pData[2] = pData[4] = pData[6] = 30000;
+    ASSERT_EQ(ADCMonitorSetDecimation(4, 0, pDecimated), 0);
+    decimate(pData);
+    EXPECT_EQ(pDecimated[0], INT16_MAX);
+
+    // Disabled again
+    ASSERT_EQ(ADCMonitorSetDecimation(1, 0, NULL), 0);
+    decimatedCallbacks = 0;
+    HAL_ADC_ConvHalfCpltCallback(&dummy);
+    ADCMonitorLoop([](int16_t *pBuffer, int noOfChannels, int noOfSamples) { decimatedCallbacks++; });
+    EXPECT_EQ(decimatedCallbacks, 1);
+}
+
+TEST_F(ADCMonitorTest, testFloatAndFixedPointAccuracy)
+{
+    const int noOfSamples = 513;
+    const int noOfChannels = 3;
+    const double q = 1 << ADC_Q_FRAC_BITS;
+    int16_t pData[noOfSamples*noOfChannels*2];
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> full(INT16_MIN, INT16_MAX);
+    std::uniform_int_distribution<int> adc12(0, 4095);
+    std::uniform_int_distribution<int> small(-3, 2);
+
+    ADC_HandleTypeDef dummy = { { noOfChannels } };
+    ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+    HAL_ADC_ConvHalfCpltCallback(&dummy);
+
+    for (int run = 0; run < 20; run++)
+    {
+        for (int i = 0; i < noOfSamples; i++)
+        {
+            pData[i*noOfChannels]     = full(rng);
+            pData[i*noOfChannels + 1] = adc12(rng);
+            pData[i*noOfChannels + 2] = small(rng);
+        }
+
+        SineWaveIndexes_t indexes = { 17, 400 };
+        for (int ch = 0; ch < noOfChannels; ch++)
+        {
+            EXPECT_NEAR(ADCrmsF(pData, ch), ADCrms(pData, ch), 1e-6 * ADCrms(pData, ch) + 1e-6);
+            EXPECT_NEAR(ADCMeanF(pData, ch), ADCMean(pData, ch), 1e-3);
+            EXPECT_NEAR(ADCAbsMeanF(pData, ch), ADCAbsMean(pData, ch), 1e-6 * ADCAbsMean(pData, ch) + 1e-6);
+            EXPECT_NEAR(ADCTrueRmsF(pData, ch, indexes), ADCTrueRms(pData, ch, indexes), 1e-6 * ADCTrueRms(pData, ch, indexes) + 1e-6);
+            EXPECT_NEAR(ADCMeanLimitedF(pData, ch, indexes), ADCMeanLimited(pData, ch, indexes), 1e-3);
+
+            // Fixed point results are truncated, i.e. within one LSB of the fraction
+            EXPECT_NEAR(ADCrmsQ(pData, ch) / q, ADCrms(pData, ch), 1 / q);
+            EXPECT_NEAR(ADCMeanQ(pData, ch) / q, ADCMean(pData, ch), 1 / q);
+            EXPECT_NEAR(ADCAbsMeanQ(pData, ch) / q, ADCAbsMean(pData, ch), 1 / q);
+            EXPECT_NEAR(ADCTrueRmsQ(pData, ch, indexes) / q, ADCTrueRms(pData, ch, indexes), 1 / q);
+            EXPECT_NEAR(ADCMeanLimitedQ(pData, ch, indexes) / q, ADCMeanLimited(pData, ch, indexes), 1 / q);
+        }
+    }
+
+    EXPECT_EQ(isqrt64(0), 0u);
+    EXPECT_EQ(isqrt64(15), 3u);
+    EXPECT_EQ(isqrt64(16), 4u);
+    EXPECT_EQ(isqrt64(UINT64_MAX), UINT32_MAX);
+    EXPECT_EQ(isqrt64(((uint64_t) 123456789) * 123456789 - 1), 123456788u);
+
+    // Sums are reduced to 32 bits before the float conversion, still within float precision
+    for (uint64_t sum : { (uint64_t) 0, (uint64_t) 12345, (uint64_t) UINT32_MAX, (uint64_t) UINT32_MAX + 1,
+                          (uint64_t) 0x123456789ABULL, (uint64_t) 0xFEDCBA9876543210ULL, UINT64_MAX })
+    {
+        EXPECT_NEAR(usumToFloat(sum), (double) sum, (double) sum * 2e-7) << sum;
+        EXPECT_NEAR(sumToFloat(-(int64_t) (sum >> 1)), -(double) (sum >> 1), (double) (sum >> 1) * 2e-7) << sum;
+    }
+    EXPECT_EQ(sumToFloat(INT64_MIN), -9223372036854775808.0f);
+
+    EXPECT_EQ(ADCrmsQ(pData, noOfChannels), 0);
+    EXPECT_EQ(ADCMeanF(NULL, 0), 0);
+}
+
+static ADCBufferInfo_t lastInfo;
+
+TEST_F(ADCMonitorTest, testADCMonitorTimestamps)
+{
+    const int noOfSamples = 10;
+    const int noOfChannels = 2;
+    int16_t pData[noOfSamples*noOfChannels*2] = {0};
+    ADCCallBackEx callback = [](int16_t *pBuffer, int noOfChannels, int noOfSamples, const ADCBufferInfo_t *info) {
+        lastInfo = *info;
+    };
+
+    ADC_HandleTypeDef dummy = { { noOfChannels } };
+    ADCMonitorInit(&dummy, pData, noOfSamples*noOfChannels*2);
+    ADCMonitorTelemetry_t telemetry;
+    ADCMonitorGetTelemetry(&telemetry);
+    EXPECT_EQ(telemetry.minPeriodCycles, UINT32_MAX);
+    EXPECT_EQ(telemetry.maxPeriodCycles, 0u);
+
+    DWT->CYCCNT = 0xFFFFF000;
+    HAL_ADC_ConvHalfCpltCallback(&dummy);
+    ADCMonitorLoopEx(callback);
+    EXPECT_EQ(lastInfo.sequence, 1u);
+    EXPECT_EQ(lastInfo.timestamp, 0xFFFFF000u);
+
+    /* The cycle counter wraps, the timestamp continues */
+    DWT->CYCCNT = 0x00000800;
+    HAL_ADC_ConvCpltCallback(&dummy);
+    ADCMonitorLoopEx(callback);
+    EXPECT_EQ(lastInfo.sequence, 2u);
+    EXPECT_EQ(lastInfo.timestamp, 0x100000800u);
+
+    DWT->CYCCNT = 0x00001700;
+    HAL_ADC_ConvHalfCpltCallback(&dummy);
+    ADCMonitorLoopEx(callback);
+    EXPECT_EQ(lastInfo.sequence, 3u);
+    EXPECT_EQ(lastInfo.timestamp, 0x100001700u);
+
+    /* Jitter between the 0x1800 and 0xF00 cycle intervals */
+    ADCMonitorGetTelemetry(&telemetry);
+    EXPECT_EQ(telemetry.minPeriodCycles, 0xF00u);
+    EXPECT_EQ(telemetry.maxPeriodCycles, 0x1800u);
+
+    ADCMonitorResetTelemetry();
+    ADCMonitorGetTelemetry(&telemetry);
+    EXPECT_EQ(telemetry.minPeriodCycles, UINT32_MAX);
+    EXPECT_EQ(telemetry.maxPeriodCycles, 0u);
+}
@@ -0,0 +1,90 @@
+/*!
+** @file   ca_rfft_tests.cpp
+** @date   16/10/2026
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cmath>
+#include <cstring>
+
+/* Fakes */
+#include "fake_arm_math.h"
+
+/* UUT */
+#include "ca_rfft.h"
+
+using namespace std;
+
+/***************************************************************************************************
+** TEST FIXTURES
+***************************************************************************************************/
+
+class CaRfftTest: public ::testing::Test
+{
+    protected:
+        /*******************************************************************************************
+        ** METHODS
+        *******************************************************************************************/
+        CaRfftTest() {}
+
+        static void generateSine(q15_t* pData, int noOfChannels, int noOfSamples, int channel, int bin)
+        {
+            for (int i = 0; i < noOfSamples; i++)
+                pData[noOfChannels*i + channel] = 8000 * sin(2*M_PI*bin*i/noOfSamples);
+        }
+};
+
+/***************************************************************************************************
+** TESTS
+***************************************************************************************************/
+
+TEST_F(CaRfftTest, testContiguous)
+{
+    const int fftLen = 64;
+    CA_rfft_ctx* ctx = ca_rfft_init(fftLen);
+    ASSERT_NE(ctx, nullptr);
+
+    q15_t slice[fftLen];
+    generateSine(slice, 1, fftLen, 0, 5);
+    q15_t copy[fftLen];
+    memcpy(copy, slice, sizeof(slice));
+
+    q15_t* out = ca_rfft_contiguous(ctx, slice);
+    ASSERT_NE(out, nullptr);
+
+    /* The input is copied, the slice is intact for later users */
+    EXPECT_EQ(memcmp(copy, slice, sizeof(slice)), 0);
+
+    q15_t x, y;
+    EXPECT_EQ(ca_rfft_absmax(out, fftLen, &x, &y), 2*5);
+    EXPECT_EQ(x, 2*5);
+    EXPECT_NEAR(y, 4000, 2);
+
+    /* Same result a second time from the same slice */
+    out = ca_rfft_contiguous(ctx, slice);
+    EXPECT_EQ(ca_rfft_absmax(out, fftLen, &x, &y), 2*5);
+
+    EXPECT_EQ(ca_rfft_contiguous(NULL, slice), nullptr);
+    EXPECT_EQ(ca_rfft_contiguous(ctx, NULL), nullptr);
+}
+
+TEST_F(CaRfftTest, testMatchesInterleaved)
+{
+    const int fftLen = 64;
+    const int noOfChannels = 3;
+    CA_rfft_ctx* ctx = ca_rfft_init(fftLen);
+    ASSERT_NE(ctx, nullptr);
+
+    int16_t pData[fftLen*noOfChannels] = {0};
+    generateSine(pData, noOfChannels, fftLen, 1, 7);
+
+    q15_t interleaved[2*fftLen];
+    memcpy(interleaved, ca_rfft(ctx, pData, noOfChannels, fftLen, 1), sizeof(interleaved));
+
+    q15_t slice[fftLen];
+    for (int i = 0; i < fftLen; i++)
+        slice[i] = pData[noOfChannels*i + 1];
+
+    EXPECT_EQ(memcmp(interleaved, ca_rfft_contiguous(ctx, slice), sizeof(interleaved)), 0);
+}
@@ -0,0 +1,170 @@
+/*!
+** @file   binarystream_tests.cpp
+** @date   15/10/2026
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cstring>
+#include <vector>
+
+/* UUT */
+#include "binaryStream.h"
+#include "crc.h"
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using namespace std;
+
+/***************************************************************************************************
+** HELPER FUNCTIONS
+***************************************************************************************************/
+
+static vector<uint8_t> cobsRoundTrip(const vector<uint8_t>& data)
+{
+    vector<uint8_t> encoded(data.size() + data.size() / 254 + 1);
+    encoded.resize(cobsEncode(data.data(), data.size(), encoded.data()));
+    EXPECT_EQ(count(encoded.begin(), encoded.end(), 0), 0);
+
+    vector<uint8_t> decoded(encoded.size());
+    int len = cobsDecode(encoded.data(), encoded.size(), decoded.data());
+    EXPECT_GE(len, 0);
+    decoded.resize(len < 0 ? 0 : len);
+    return decoded;
+}
+
+/***************************************************************************************************
+** TESTS
+***************************************************************************************************/
+
+TEST(BinaryStream, test_crc16)
+{
+    const uint8_t check[] = "123456789";
+    EXPECT_EQ(crc16Calculate(CRC16_INIT, check, 9), 0x29B1);
+    EXPECT_EQ(crc16Calculate(crc16Calculate(CRC16_INIT, check, 4), &check[4], 5), 0x29B1);
+}
+
+TEST(BinaryStream, test_cobs)
+{
+    const uint8_t data[] = {0x11, 0x22, 0x00, 0x33};
+    uint8_t encoded[8];
+    EXPECT_EQ(cobsEncode(data, sizeof(data), encoded), 5u);
+    EXPECT_THAT(vector<uint8_t>(encoded, encoded + 5), ElementsAre(0x03, 0x11, 0x22, 0x02, 0x33));
+
+    vector<vector<uint8_t>> cases = {{}, {0}, {0, 0}, {1}, vector<uint8_t>(254, 7),
+                                     vector<uint8_t>(255, 7), vector<uint8_t>(600, 9)};
+    cases[6][300] = 0;
+    for (const auto& data : cases)
+    {
+        EXPECT_EQ(cobsRoundTrip(data), data);
+    }
+
+    /* Code past the end and zero inside the frame are invalid */
+    const uint8_t bad1[] = {0x05, 0x11};
+    const uint8_t bad2[] = {0x03, 0x11, 0x00};
+    uint8_t out[4];
+    EXPECT_EQ(cobsDecode(bad1, sizeof(bad1), out), -1);
+    EXPECT_EQ(cobsDecode(bad2, sizeof(bad2), out), -1);
+}
+
+TEST(BinaryStream, test_roundTripRaw)
+{
+    /* 3 channels, 4 samples, channels 0 and 2 streamed. Values with zero bytes */
+    const int16_t adc[] = {0, 1, 256, -1, 2, -256, 32767, 3, -32768, 0x1200, 4, 0x0012};
+    BStreamHeader_t hdr = { BSTREAM_INT16, 4, 0x01020304, 0x1122334455667788ULL, 0x5 };
+
+    uint8_t frame[BSTREAM_FRAME_SIZE(4 * 2 * sizeof(int16_t))];
+    size_t len = bstreamEncode(frame, sizeof(frame), &hdr, adc, 3, NULL);
+    ASSERT_GT(len, 0u);
+    EXPECT_EQ(frame[len - 1], 0);
+    EXPECT_EQ(count(frame, frame + len - 1, 0), 0);
+
+    BStreamHeader_t decoded;
+    float samples[16];
+    ASSERT_EQ(bstreamDecode(frame, len - 1, &decoded, samples, 16), 8);
+    EXPECT_EQ(decoded.format, BSTREAM_INT16);
+    EXPECT_EQ(decoded.noOfSamples, 4);
+    EXPECT_EQ(decoded.sequence, hdr.sequence);
+    EXPECT_EQ(decoded.timestamp, hdr.timestamp);
+    EXPECT_EQ(decoded.channelMask, hdr.channelMask);
+    EXPECT_THAT(vector<float>(samples, samples + 8), ElementsAre(0, 256, -1, -256, 32767, -32768, 0x1200, 0x0012));
+}
+
+TEST(BinaryStream, test_roundTripScaled)
+{
+    const int16_t adc[] = {100, -200, 300, -400};
+    const float scale[] = {0.5f, 0.25f};
+    BStreamHeader_t hdr = { BSTREAM_FLOAT32, 2, 7, 1000, 0x3 };
+
+    uint8_t frame[64];
+    size_t len = bstreamEncode(frame, sizeof(frame), &hdr, adc, 2, scale);
+    ASSERT_EQ(len, BSTREAM_FRAME_SIZE(4 * sizeof(float)));
+
+    BStreamHeader_t decoded;
+    float samples[4];
+    ASSERT_EQ(bstreamDecode(frame, len - 1, &decoded, samples, 4), 4);
+    EXPECT_EQ(decoded.format, BSTREAM_FLOAT32);
+    EXPECT_THAT(samples, ElementsAre(50.0f, -50.0f, 150.0f, -100.0f));
+}
+
+TEST(BinaryStream, test_invalid)
+{
+    const int16_t adc[256 * 2] = {0};
+    BStreamHeader_t hdr = { BSTREAM_INT16, 256, 0, 0, 0x3 };
+    uint8_t frame[BSTREAM_FRAME_SIZE(256 * 2 * sizeof(int16_t))];
+
+    /* Frame too large, channels not in the buffer, no scale */
+    EXPECT_EQ(bstreamEncode(frame, sizeof(frame) - 1, &hdr, adc, 2, NULL), 0u);
+    hdr.channelMask = 0x4;
+    EXPECT_EQ(bstreamEncode(frame, sizeof(frame), &hdr, adc, 2, NULL), 0u);
+    hdr.channelMask = 0x3;
+    hdr.format = BSTREAM_FLOAT32;
+    EXPECT_EQ(bstreamEncode(frame, sizeof(frame), &hdr, adc, 2, NULL), 0u);
+
+    /* Any corrupted byte is detected */
+    hdr.format = BSTREAM_INT16;
+    hdr.noOfSamples = 3;
+    size_t len = bstreamEncode(frame, sizeof(frame), &hdr, adc, 2, NULL);
+    ASSERT_GT(len, 0u);
+    float samples[6];
+    for (size_t i = 0; i < len - 1; i++)
+    {
+        uint8_t copy[sizeof(frame)];
+        memcpy(copy, frame, len);
+        copy[i] ^= 0x40;
+        EXPECT_EQ(bstreamDecode(copy, len - 1, &hdr, samples, 6), -1) << "byte " << i;
+    }
+
+    /* Too many samples for the caller */
+    EXPECT_EQ(bstreamDecode(frame, len - 1, &hdr, samples, 5), -1);
+}
+
+TEST(BinaryStream, test_resync)
+{
+    /* The host splits the stream at 0 bytes and drops what does not decode */
+    const int16_t adc[] = {1, 2, 3, 4};
+    uint8_t stream[128];
+    size_t len = 0;
+    stream[len++] = 0x42; // Tail of a lost frame
+    stream[len++] = 0x00;
+    for (uint32_t seq = 1; seq <= 2; seq++)
+    {
+        BStreamHeader_t hdr = { BSTREAM_INT16, 2, seq, seq * 100, 0x3 };
+        len += bstreamEncode(&stream[len], sizeof(stream) - len, &hdr, adc, 2, NULL);
+    }
+
+    vector<uint32_t> received;
+    size_t start = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (stream[i] != 0)
+            continue;
+
+        BStreamHeader_t hdr;
+        float samples[4];
+        if (bstreamDecode(&stream[start], i - start, &hdr, samples, 4) == 4)
+            received.push_back(hdr.sequence);
+        start = i + 1;
+    }
+    EXPECT_THAT(received, ElementsAre(1, 2));
+}
@@ -0,0 +1,108 @@
+/*!
+** @file   csvline_benchmark.cpp
+** @brief  Host benchmark of the CSV line builder against snprintf
+** @date   15/10/2026
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+/* UUT */
+#include "csvLine.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/***************************************************************************************************
+** TEST FIXTURES
+***************************************************************************************************/
+
+class CsvLineBenchmark: public ::testing::Test
+{
+    protected:
+        /*******************************************************************************************
+        ** MEMBERS
+        *******************************************************************************************/
+        static const int noOfChannels = 16;
+        static const int repetitions  = 20000;
+
+        float values[noOfChannels];
+        char line[512];
+
+        /*******************************************************************************************
+        ** METHODS
+        *******************************************************************************************/
+        CsvLineBenchmark()
+        {
+            for (int i = 0; i < noOfChannels; i++)
+            {
+                values[i] = 230.0f * sinf(i * 0.7f) + i * 0.013f;
+            }
+        }
+
+        /* Runs the function a number of times and returns the average time per call in ns */
+        template<typename F>
+        static double timeIt(F func)
+        {
+            auto begin = steady_clock::now();
+            for (int i = 0; i < repetitions; i++)
+            {
+                func();
+            }
+            auto end = steady_clock::now();
+            return duration_cast<nanoseconds>(end - begin).count() / (double) repetitions;
+        }
+
+        /* The per tick data line as built today */
+        int snprintfLine(char *buf, size_t size)
+        {
+            int len = 0;
+            for (int ch = 0; ch < noOfChannels; ch++)
+            {
+                len += snprintf(&buf[len], size - len, (ch == 0) ? "%.2f" : ", %.2f", values[ch]);
+            }
+            len += snprintf(&buf[len], size - len, "\r\n");
+            return len;
+        }
+
+        int csvLine(char *buf, size_t size)
+        {
+            CsvLine_t csv;
+            csvInit(&csv, buf, size);
+            for (int ch = 0; ch < noOfChannels; ch++)
+            {
+                csvAppendFixed(&csv, values[ch], 2);
+            }
+            return csvEndLine(&csv);
+        }
+};
+
+/***************************************************************************************************
+** TESTS
+***************************************************************************************************/
+
+TEST_F(CsvLineBenchmark, benchmarkDataLine)
+{
+    char reference[sizeof(line)];
+    ASSERT_EQ(snprintfLine(reference, sizeof(reference)), csvLine(line, sizeof(line)));
+    ASSERT_STREQ(reference, line);
+
+    /* Volatile sink prevents the compiler from removing the loops */
+    volatile int sink = 0;
+    double printfTime = timeIt([&]() {
+        sink = sink + snprintfLine(line, sizeof(line));
+        values[0] += 0.01f;
+    });
+    double csvTime = timeIt([&]() {
+        sink = sink + csvLine(line, sizeof(line));
+        values[0] += 0.01f;
+    });
+
+    /* Timings are only reported, they are too noisy on shared CI runners to assert on */
+    printf("%d channels %%.2f per line\r\n", noOfChannels);
+    printf("  snprintf:       %10.0f ns\r\n", printfTime);
+    printf("  csvAppendFixed: %10.0f ns (%.1fx)\r\n", csvTime, printfTime / csvTime);
+}
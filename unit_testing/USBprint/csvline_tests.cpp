@@ -0,0 +1,148 @@
+/*!
+** @file   csvline_tests.cpp
+** @date   15/10/2026
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+
+/* UUT */
+#include "csvLine.h"
+
+using namespace std;
+
+/***************************************************************************************************
+** HELPER FUNCTIONS
+***************************************************************************************************/
+
+static string fixed(float value, int decimals)
+{
+    char buf[CSV_FIELD_MAX];
+    CsvLine_t csv;
+    csvInit(&csv, buf, sizeof(buf));
+    csvAppendFixed(&csv, value, decimals);
+    return buf;
+}
+
+static string printfFixed(float value, int decimals)
+{
+    char buf[CSV_FIELD_MAX];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    return buf;
+}
+
+static void sinkWrite(void *ctx, const char *data, size_t len)
+{
+    ((string*) ctx)->append(data, len);
+}
+
+/***************************************************************************************************
+** TESTS
+***************************************************************************************************/
+
+TEST(CsvLine, test_line)
+{
+    char buf[128];
+    CsvLine_t csv;
+    csvInit(&csv, buf, sizeof(buf));
+    csvAppendInt(&csv, 42);
+    csvAppendInt(&csv, INT32_MIN);
+    csvAppendFixed(&csv, 3.14159f, 2);
+    csvAppendFixed(&csv, -0.001f, 2);
+    csvAppendHex(&csv, 0xBEEF, 8);
+    csvAppendHex(&csv, 0, 0);
+    int len = csvEndLine(&csv);
+    EXPECT_EQ(len, (int) strlen(buf));
+    EXPECT_STREQ(buf, "42, -2147483648, 3.14, -0.00, 0x0000beef, 0x0\r\n");
+}
+
+TEST(CsvLine, test_matchesPrintf)
+{
+    const float values[] = {0.0f, -0.0f, 0.5f, 1.5f, 2.5f, -2.5f, 0.125f, 0.375f, 1e-10f, 1e-45f,
+                            123456.789f, 16777216.0f, 1e10f, 9.2e18f, 1e30f, -3.4e38f, 0.045f,
+                            2.675f, 1.005f, 999.9995f};
+    for (float value : values)
+    {
+        for (int decimals = 0; decimals <= CSV_MAX_DECIMALS; decimals++)
+        {
+            EXPECT_EQ(fixed(value, decimals), printfFixed(value, decimals)) << value << " " << decimals;
+        }
+    }
+
+    EXPECT_EQ(fixed(INFINITY, 2), "inf");
+    EXPECT_EQ(fixed(-INFINITY, 2), "-inf");
+    EXPECT_EQ(fixed(NAN, 2), "nan");
+
+    /* Random bit patterns over the whole float range */
+    mt19937 gen(1);
+    int mismatches = 0;
+    for (int i = 0; i < 200000; i++)
+    {
+        uint32_t bits = gen();
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        if (!isfinite(value))
+            continue;
+
+        int decimals = gen() % (CSV_MAX_DECIMALS + 1);
+        if (fixed(value, decimals) != printfFixed(value, decimals))
+            mismatches++;
+    }
+    EXPECT_EQ(mismatches, 0);
+
+    /* Integers and hex */
+    for (int i = 0; i < 10000; i++)
+    {
+        int32_t value = (int32_t) gen();
+        char expected[32];
+        char buf[64];
+        CsvLine_t csv;
+        csvInit(&csv, buf, sizeof(buf));
+        csvAppendInt(&csv, value);
+        csvAppendHex(&csv, (uint32_t) value, i % 10);
+        snprintf(expected, sizeof(expected), "%" PRId32 ", 0x%0*" PRIx32, value, i % 10, (uint32_t) value);
+        EXPECT_STREQ(buf, expected);
+    }
+}
+
+TEST(CsvLine, test_overflow)
+{
+    /* Fields that do not fit are dropped */
+    char buf[10];
+    CsvLine_t csv;
+    csvInit(&csv, buf, sizeof(buf));
+    csvAppendInt(&csv, 1234);
+    csvAppendInt(&csv, 56789);
+    csvAppendInt(&csv, 1);
+    EXPECT_STREQ(buf, "1234, 1");
+    EXPECT_EQ(csvEndLine(&csv), -1);
+    EXPECT_STREQ(buf, "1234, 1\r\n");
+}
+
+TEST(CsvLine, test_write)
+{
+    /* A line longer than the staging buffer is passed on in pieces */
+    string out;
+    char buf[CSV_FIELD_MAX];
+    CsvLine_t csv;
+    csvInitWrite(&csv, buf, sizeof(buf), sinkWrite, &out);
+
+    string expected;
+    for (int i = 0; i < 40; i++)
+    {
+        csvAppendFixed(&csv, i * 1.25f, 3);
+        char field[32];
+        snprintf(field, sizeof(field), "%s%.3f", (i == 0) ? "" : ", ", i * 1.25f);
+        expected += field;
+    }
+    expected += "\r\n";
+
+    EXPECT_EQ(csvEndLine(&csv), (int) expected.size());
+    EXPECT_EQ(out, expected);
+}
@@ -0,0 +1,150 @@
+/*!
+** @file   outstream_tests.cpp
+** @date   16/10/2026
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <string>
+
+/* UUT */
+#include "outStream.h"
+#include "csvLine.h"
+
+using namespace std;
+
+/***************************************************************************************************
+** HELPER CLASS / FUNCTIONS
+***************************************************************************************************/
+
+/* Transport writing to a string of limited capacity */
+class MemStream
+{
+    public:
+        MemStream(size_t _capacity) : capacity(_capacity), writes(0), flushes(0), flushRet(0), fail(false)
+        {
+            stream = { write, available, flush, this };
+        }
+
+        OutStream_t stream;
+        string data;
+        size_t capacity;
+        int writes;
+        int flushes;
+        int flushRet;
+        bool fail;
+
+    private:
+        static ssize_t write(void *ctx, const uint8_t *buf, size_t len)
+        {
+            MemStream *mem = (MemStream*) ctx;
+            mem->writes++;
+            if (mem->fail)
+                return -1;
+            len = min(len, mem->capacity - mem->data.size());
+            mem->data.append((const char*) buf, len);
+            return len;
+        }
+
+        static size_t available(void *ctx)
+        {
+            MemStream *mem = (MemStream*) ctx;
+            return mem->capacity - mem->data.size();
+        }
+
+        static int flush(void *ctx)
+        {
+            MemStream *mem = (MemStream*) ctx;
+            mem->flushes++;
+            return mem->flushRet;
+        }
+};
+
+/***************************************************************************************************
+** TESTS
+***************************************************************************************************/
+
+TEST(OutStream, test_single)
+{
+    MemStream mem(100);
+    EXPECT_EQ(outPrintf(&mem.stream, "%d, %.2f, %s\r\n", 12, 3.14159, "ok"), 14);
+    EXPECT_EQ(mem.data, "12, 3.14, ok\r\n");
+    EXPECT_EQ(outAvailable(&mem.stream), 86u);
+    EXPECT_EQ(outFlush(&mem.stream), 0);
+    EXPECT_EQ(mem.flushes, 1);
+
+    /* Missing functions */
+    OutStream_t empty = { NULL, NULL, NULL, NULL };
+    EXPECT_EQ(outWrite(&empty, "a", 1), -1);
+    EXPECT_EQ(outAvailable(&empty), 0u);
+    EXPECT_EQ(outFlush(&empty), 0);
+}
+
+TEST(OutStream, test_fanout)
+{
+    MemStream usb(100), eth(100), uart(10);
+    OutStream_t all;
+    OutFanout_t fanout;
+    outFanoutInit(&all, &fanout);
+    EXPECT_EQ(outAvailable(&all), 0u);
+    EXPECT_EQ(outFanoutAdd(&fanout, &usb.stream), 0);
+    EXPECT_EQ(outFanoutAdd(&fanout, &eth.stream), 0);
+
+    /* Formatted once, every piece goes to every stream */
+    EXPECT_EQ(outPrintf(&all, "%s %d\r\n", "line", 1), 8);
+    EXPECT_EQ(usb.data, "line 1\r\n");
+    EXPECT_EQ(eth.data, usb.data);
+    EXPECT_EQ(usb.writes, eth.writes);
+
+    /* A CSV line built straight into the fan-out */
+    char buf[CSV_FIELD_MAX];
+    CsvLine_t csv;
+    csvInitWrite(&csv, buf, sizeof(buf), outStreamWrite, &all);
+    csvAppendInt(&csv, 7);
+    csvAppendFixed(&csv, 1.5f, 1);
+    csvEndLine(&csv);
+    EXPECT_EQ(eth.data, "line 1\r\n7, 1.5\r\n");
+    EXPECT_EQ(usb.data, eth.data);
+
+    /* Least accepted and available of all streams */
+    EXPECT_EQ(outFanoutAdd(&fanout, &uart.stream), 0);
+    EXPECT_EQ(outAvailable(&all), 10u);
+    EXPECT_EQ(outWrite(&all, "0123456789abc", 13), 10);
+    EXPECT_EQ(outAvailable(&all), 0u);
+
+    /* Flush reaches all, fails if one failed */
+    eth.flushRet = -1;
+    EXPECT_EQ(outFlush(&all), -1);
+    EXPECT_EQ(usb.flushes, 1);
+    EXPECT_EQ(uart.flushes, 1);
+
+    EXPECT_EQ(outFanoutAdd(&fanout, &usb.stream), 0);
+    EXPECT_EQ(outFanoutAdd(&fanout, &usb.stream), -1);
+}
+
+TEST(OutStream, test_writeResults)
+{
+    /* A cut output returns what the stream accepted */
+    MemStream mem(10);
+    EXPECT_EQ(outPrintf(&mem.stream, "%s-%d", "0123456789", 1), 10);
+    EXPECT_EQ(mem.data, "0123456789");
+
+    /* A failing write fails the print */
+    MemStream broken(100);
+    broken.fail = true;
+    EXPECT_EQ(outPrintf(&broken.stream, "%d", 1), -1);
+
+    /* In a fan-out the other streams still get everything, the write returns the error */
+    MemStream usb(100);
+    OutStream_t all;
+    OutFanout_t fanout;
+    outFanoutInit(&all, &fanout);
+    EXPECT_EQ(outFanoutAdd(&fanout, &broken.stream), 0);
+    EXPECT_EQ(outFanoutAdd(&fanout, &usb.stream), 0);
+    EXPECT_EQ(outWrite(&all, "abc", 3), -1);
+    EXPECT_EQ(outPrintf(&all, "%s %d\r\n", "line", 2), -1);
+    EXPECT_EQ(usb.data, "abcline 2\r\n");
+
+    broken.fail = false;
+    EXPECT_EQ(outPrintf(&all, "ok"), 2);
+}
@@ -0,0 +1,124 @@
+/*!
+** @file   uartstream_tests.cpp
+** @date   16/10/2026
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <vector>
+
+/* Fakes */
+#include "fake_stm32xxxx_hal.h"
+
+/* UUT */
+#include "uartStream.c"
+
+using ::testing::ElementsAre;
+using namespace std;
+
+/***************************************************************************************************
+** HELPER CLASS / FUNCTIONS
+***************************************************************************************************/
+
+/* UART recording each transmit, failing from a given transmit on */
+class UartDevice : public stm32UartTestDevice
+{
+    public:
+        UartDevice(USART_TypeDef* _bus) : failFrom(-1)
+        {
+            bus = _bus;
+            fakeHAL_UART_addDevice(this);
+        }
+
+        vector<uint16_t> sizes;
+        vector<uint32_t> timeouts;
+        vector<uint8_t> data;
+        int failFrom;
+
+        HAL_StatusTypeDef transmit(const uint8_t* buf, uint16_t size, uint32_t timeout)
+        {
+            if (failFrom >= 0 && (int) sizes.size() >= failFrom)
+                return HAL_TIMEOUT;
+
+            sizes.push_back(size);
+            timeouts.push_back(timeout);
+            data.insert(data.end(), buf, buf + size);
+            return HAL_OK;
+        }
+};
+
+static UartDevice uart1(USART1);
+static UartDevice uart2(USART2);
+
+/***************************************************************************************************
+** TEST FIXTURES
+***************************************************************************************************/
+
+class UartStreamTest : public ::testing::Test
+{
+    protected:
+        void SetUp()
+        {
+            huart.Instance = USART1;
+            huart.Init.BaudRate = 115200;
+            uartOutStreamInit(&huart, &stream);
+
+            uart1.sizes.clear();
+            uart1.timeouts.clear();
+            uart1.data.clear();
+            uart1.failFrom = -1;
+        }
+
+        UART_HandleTypeDef huart = {};
+        OutStream_t stream;
+};
+
+/***************************************************************************************************
+** TESTS
+***************************************************************************************************/
+
+TEST_F(UartStreamTest, test_timeoutScalesWithLength) {
+    /* 1200 bytes take 125 ms at 115200 baud, more than the margin alone */
+    vector<uint8_t> buf(1200, 'u');
+    EXPECT_EQ(1200, outWrite(&stream, buf.data(), buf.size()));
+    EXPECT_THAT(uart1.sizes, ElementsAre(1200));
+    EXPECT_THAT(uart1.timeouts, ElementsAre(125 + UART_STREAM_TIMEOUT_MS));
+
+    /* Slower UART, longer timeout */
+    huart.Init.BaudRate = 9600;
+    EXPECT_EQ(10, outWrite(&stream, buf.data(), 10));
+    EXPECT_EQ(13 + UART_STREAM_TIMEOUT_MS, uart1.timeouts.back());
+}
+
+TEST_F(UartStreamTest, test_chunks) {
+    /* Longer than a HAL transmit, sent in chunks with their own timeouts */
+    vector<uint8_t> buf(70000);
+    for (size_t i = 0; i < buf.size(); i++)
+        buf[i] = (uint8_t) i;
+
+    EXPECT_EQ(70000, outWrite(&stream, buf.data(), buf.size()));
+    EXPECT_THAT(uart1.sizes, ElementsAre(65535, 4465));
+    EXPECT_THAT(uart1.timeouts, ElementsAre(6827 + UART_STREAM_TIMEOUT_MS, 466 + UART_STREAM_TIMEOUT_MS));
+    EXPECT_EQ(buf, uart1.data);
+    EXPECT_TRUE(uart2.data.empty());
+
+    EXPECT_EQ(SIZE_MAX, outAvailable(&stream));
+    EXPECT_EQ(0, outFlush(&stream));
+}
+
+TEST_F(UartStreamTest, test_errors) {
+    vector<uint8_t> buf(70000, 'e');
+
+    /* A failing chunk returns what was sent before it */
+    uart1.failFrom = 1;
+    EXPECT_EQ(65535, outWrite(&stream, buf.data(), buf.size()));
+
+    /* -1 if nothing was sent */
+    uart1.failFrom = 0;
+    EXPECT_EQ(-1, outWrite(&stream, buf.data(), 10));
+
+    /* A UART without a device fails */
+    huart.Instance = USART6;
+    EXPECT_EQ(-1, outWrite(&stream, buf.data(), 10));
+    EXPECT_THAT(uart1.sizes, ElementsAre(65535));
+}
@@ -6,6 +6,8 @@
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <cmath>
+#include <cwchar>
 
 /* Fakes */
 #include "fake_usbd_cdc.h"
@@ -127,6 +129,63 @@ TEST_F(UsbPrintTest, test_usbRecv) {
     EXPECT_STREQ((char*) buf, "Test String\n12345");
 }
 
+TEST_F(UsbPrintTest, test_usbRxLine) {
+    usb_cdc_fops.Init();
+
+    /* Several lines in a packet, a line split over packets */
+    uint8_t line[8];
+    EXPECT_EQ(usbRxLine(line, sizeof(line)), 0);
+    sendUsbData("ab\r\ncd\n12");
+    EXPECT_EQ(usbRxLine(line, sizeof(line)), 2);
+    EXPECT_STREQ((char*) line, "ab");
+    EXPECT_EQ(usbRxLine(line, sizeof(line)), 2);
+    EXPECT_STREQ((char*) line, "cd");
+    EXPECT_EQ(usbRxLine(line, sizeof(line)), 0);
+    sendUsbData("345\r");
+    EXPECT_EQ(usbRxLine(line, sizeof(line)), 5);
+    EXPECT_STREQ((char*) line, "12345");
+
+    /* Too long lines are cut */
+    sendUsbData("abcdefghij\nk\n");
+    EXPECT_EQ(usbRxLine(line, 5), 4);
+    EXPECT_STREQ((char*) line, "abcd");
+    EXPECT_EQ(usbRxLine(line, 5), 1);
+    EXPECT_STREQ((char*) line, "k");
+
+    /* Flushed lines are gone */
+    sendUsbData("xy\n");
+    usbFlush();
+    EXPECT_EQ(usbRxLine(line, sizeof(line)), 0);
+
+    /* More lines than the queue holds are all read in order */
+    sendUsbData("0\n1\n2\n3\n4\n5\n6\n7\n8\n9\n");
+    sendUsbData("a\nb\nc\nd\ne\nf\ng\nh\n");
+    const char expected[] = "0123456789abcdefgh";
+    for (size_t i = 0; i < strlen(expected); i++) {
+        EXPECT_EQ(usbRxLine(line, sizeof(line)), 1);
+        EXPECT_EQ(line[0], expected[i]);
+    }
+    EXPECT_EQ(usbRxLine(line, sizeof(line)), 0);
+    EXPECT_EQ(usbRx(line), -1);
+
+    /* A cut line in a merged entry of the full queue, the lines after it are kept */
+    sendUsbData("0\n1\n2\n3\n4\n5\n6\n7\n");
+    sendUsbData("8\n9\na\nb\nc\nd\ne\n");
+    sendUsbData("longer line\nx\ny\n");
+    for (size_t i = 0; i < 15; i++) {
+        EXPECT_EQ(usbRxLine(line, sizeof(line)), 1);
+        EXPECT_EQ(line[0], expected[i]);
+    }
+    EXPECT_EQ(usbRxLine(line, 5), 4);
+    EXPECT_STREQ((char*) line, "long");
+    EXPECT_EQ(usbRxLine(line, sizeof(line)), 1);
+    EXPECT_STREQ((char*) line, "x");
+    EXPECT_EQ(usbRxLine(line, sizeof(line)), 1);
+    EXPECT_STREQ((char*) line, "y");
+    EXPECT_EQ(usbRxLine(line, sizeof(line)), 0);
+    EXPECT_EQ(usbRx(line), -1);
+}
+
 TEST_F(UsbPrintTest, test_delayedSend) {
     usb_cdc_fops.Init();
 
@@ -146,8 +205,411 @@ TEST_F(UsbPrintTest, test_delayedSend) {
     uint8_t buf[len];
     usb_cdc_fops.TransmitCplt(buf, &len, 0);
 
-    EXPECT_EQ(txAvailable(), 1024);
+    /* Sent directly from the ring, the space is released when the packet is complete */
+    EXPECT_EQ(txAvailable(), 1024 - 19 - 16);
     EXPECT_READ_USB(IsSupersetOf({"test_delayed_send\r", "second message\r"}));
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(txAvailable(), 1024);
+}
+
+TEST_F(UsbPrintTest, test_pingPongSend) {
+    usb_cdc_fops.Init();
+    uint32_t len = 10;
+    uint8_t buf[len];
+
+    /* Stage more than half the ring while a transfer is on the wire */
+    ((USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData)->TxState = 1;
+    char data[800];
+    memset(data, 'a', sizeof(data));
+    EXPECT_EQ(800, writeUSB(data, sizeof(data)));
+
+    /* Transfers are limited to half the ring, the rest is staged for the next one */
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(CDC_TX_TRANSFER_SIZE, hUsbDeviceFS.tx_count);
+    EXPECT_EQ(txAvailable(), 1024 - 800);
+
+    /* The main loop refills the half released by the first transfer */
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(800 - CDC_TX_TRANSFER_SIZE, hUsbDeviceFS.tx_count);
+    EXPECT_EQ(txAvailable(), 1024 - 800 + CDC_TX_TRANSFER_SIZE);
+    EXPECT_EQ(CDC_TX_TRANSFER_SIZE, writeUSB(data, CDC_TX_TRANSFER_SIZE));
+
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(CDC_TX_TRANSFER_SIZE - 800 + CDC_TX_TRANSFER_SIZE, hUsbDeviceFS.tx_count);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(800 - CDC_TX_TRANSFER_SIZE, hUsbDeviceFS.tx_count);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(txAvailable(), 1024);
+    ((USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData)->TxState = 0;
+}
+
+TEST_F(UsbPrintTest, test_coalescing) {
+    usb_cdc_fops.Init();
+    usbTxCountersReset();
+    DWT->CYCCNT = 0;
+    usbTxCoalesce(100); // 1600 cycles at the 16 MHz of the fake
+
+    UsbTxCounters tx;
+    uint32_t len = 10;
+    uint8_t buf[len];
+
+    /* Small writes are gathered */
+    EXPECT_EQ(10, USBnprintf("%08d\r\n", 1));
+    EXPECT_EQ(10, USBnprintf("%08d\r\n", 2));
+    usbTxCounters(&tx);
+    EXPECT_EQ(0, tx.packets);
+    EXPECT_EQ(txAvailable(), 1024 - 20);
+
+    /* Sent when the oldest byte has timed out */
+    DWT->CYCCNT = 1599;
+    usbTxPoll();
+    usbTxCounters(&tx);
+    EXPECT_EQ(0, tx.packets);
+    DWT->CYCCNT = 1600;
+    usbTxPoll();
+    usbTxCounters(&tx);
+    EXPECT_EQ(1, tx.packets);
+    EXPECT_EQ(20, tx.sent);
+    EXPECT_EQ(20, hUsbDeviceFS.tx_count);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(txAvailable(), 1024);
+
+    /* Sent when a packet is full */
+    for (int i = 0; i < 6; i++) {
+        USBnprintf("%08d\r\n", i);
+    }
+    usbTxCounters(&tx);
+    EXPECT_EQ(1, tx.packets);
+    USBnprintf("%08d\r\n", 6);
+    usbTxCounters(&tx);
+    EXPECT_EQ(3, tx.packets); // 70 bytes, a full and a short packet
+    EXPECT_EQ(90, tx.sent);
+
+    /* While busy data is gathered until a packet is full or a flush */
+    ((USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData)->TxState = 1;
+    USBnprintf("%08d\r\n", 7);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    usbTxCounters(&tx);
+    EXPECT_EQ(3, tx.packets);
+    EXPECT_EQ(0, usbTxFlush());
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    usbTxCounters(&tx);
+    EXPECT_EQ(4, tx.packets);
+    EXPECT_EQ(100, tx.sent);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(txAvailable(), 1024);
+    ((USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData)->TxState = 0;
+
+    /* Without coalescing every write is sent at once */
+    usbTxCoalesce(0);
+    USBnprintf("%08d\r\n", 8);
+    usbTxCounters(&tx);
+    EXPECT_EQ(5, tx.packets);
+    EXPECT_EQ(110, tx.sent);
+    EXPECT_EQ(txAvailable(), 1024);
+}
+
+static void appendString(void *ctx, const char *data, size_t len) {
+    ((string *) ctx)->append(data, len);
+}
+
+static string formatString(const char *format, ...) {
+    string out;
+    va_list args;
+    va_start(args, format);
+    int len = vformat(appendString, &out, format, args);
+    EXPECT_EQ(len, (int) out.size());
+    va_end(args);
+    return out;
+}
+
+static string referenceString(const char *format, ...) {
+    char buf[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    return string(buf);
+}
+
+#define EXPECT_FORMAT(...) EXPECT_EQ(referenceString(__VA_ARGS__), formatString(__VA_ARGS__))
+
+TEST(VFormat, test_matchesVsnprintf) {
+    EXPECT_FORMAT("plain text");
+    EXPECT_FORMAT("%d %i %u %x %X %o %%", -12, 34, 56u, 0xabcu, 0xABCu, 8u);
+    EXPECT_FORMAT("%ld %lu %lld %llu %zu %hd %hhu", -1L, 2UL, -3LL, 4ULL, (size_t) 5, (short) -6, (unsigned char) 7);
+    EXPECT_FORMAT("[%8x] [%-8d] [%08d] [%+d] [% d] [%#x]", 0x1234u, 42, -42, 5, 6, 0xffu);
+    EXPECT_FORMAT("%f %.4f %09.4f %e %g %.3g", 392.65, 392.65, 987.654, 1.5e-7, 0.0001, 1234567.0);
+    EXPECT_FORMAT("[%*d] [%-*d] [%.*f] [%*.*f]", 6, 1, 6, 2, 2, 3.14159, -8, 1, 2.5);
+    EXPECT_FORMAT("[%s] [%10s] [%-10s] [%.3s] [%c]", "abc", "right", "left", "truncated", 'z');
+    EXPECT_FORMAT("%s", (const char *) NULL);
+}
+
+static int formatLength(const char *format, ...) {
+    string out;
+    va_list args;
+    va_start(args, format);
+    int len = vformat(appendString, &out, format, args);
+    va_end(args);
+    return len;
+}
+
+TEST(VFormat, test_wideFields) {
+    /* Wider than VFORMAT_NUMBER_MAX, padded outside the number buffer */
+    EXPECT_FORMAT("[%100d] [%-100d] [%0100d] [%+0100d] [% 0100d]", 1, -2, -3, 4, 5);
+    EXPECT_FORMAT("[%#0100x] [%0100.5d] [%0100o] [%100c] [%-100p]", 0xabu, 6, 7u, 'q', (void *) 0x1234);
+    EXPECT_FORMAT("[%0100.3f] [%-100e] [%0100g] [%0100a] [%*.*f]", -1.5, 2.5, 3.5, 4.5, -100, 2, 5.5);
+    EXPECT_FORMAT("[%0*d] [%100s] [%010f] [%010f]", 100, -8, "str", INFINITY, -NAN);
+}
+
+TEST(VFormat, test_numberTooLong) {
+    /* Conversions longer than VFORMAT_NUMBER_MAX fail instead of being cut */
+    EXPECT_EQ(-1, formatLength("%.70f", 1.0 / 3.0));
+    EXPECT_EQ(-1, formatLength("%f", 1e300));
+    EXPECT_EQ(-1, formatLength("%.70d", 1));
+    EXPECT_EQ(VFORMAT_NUMBER_MAX - 1, formatLength("%.*f", VFORMAT_NUMBER_MAX - 3, 1.0));
+
+    /* Wide characters are not supported */
+    EXPECT_EQ(-1, formatLength("%ls", L"wide"));
+    EXPECT_EQ(-1, formatLength("%lc", (wint_t) L'w'));
+}
+
+TEST(VFormat, test_longOutput) {
+    string longArg(2000, 'x');
+    string out = formatString("%s-%d", longArg.c_str(), 7);
+    EXPECT_EQ(2002, out.size());
+}
+
+TEST_F(UsbPrintTest, test_longLines) {
+    usb_cdc_fops.Init();
+    usbTxCountersReset();
+
+    /* Longer than the old 256 byte line buffer, sent directly when idle */
+    string line(600, 'a');
+    EXPECT_EQ(602, USBnprintf("%s\r\n", line.c_str()));
+    EXPECT_EQ(602, hUsbDeviceFS.tx_count);
+    EXPECT_EQ(0, memcmp(hUsbDeviceFS.tx_buf, line.c_str(), 600));
+    EXPECT_EQ(txAvailable(), 1024);
+
+    /* Longer than the transfer buffer, the rest is queued in the ring */
+    string longer(1500, 'b');
+    EXPECT_EQ(1500, USBnprintf("%s", longer.c_str()));
+    EXPECT_EQ(1024, hUsbDeviceFS.tx_count);
+    EXPECT_EQ(txAvailable(), 1024 - 476);
+
+    uint32_t len = 10;
+    uint8_t buf[len];
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(476, hUsbDeviceFS.tx_count);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(txAvailable(), 1024);
+
+    UsbTxCounters tx;
+    usbTxCounters(&tx);
+    EXPECT_EQ(2102, tx.sent);
+    EXPECT_EQ(0, tx.dropped);
+}
+
+TEST_F(UsbPrintTest, test_printBackpressure) {
+    usb_cdc_fops.Init();
+    usbTxCountersReset();
+
+    /* While busy the output goes to the ring, what does not fit is dropped and counted */
+    ((USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData)->TxState = 1;
+    string line(1000, 'c');
+    EXPECT_EQ(1000, USBnprintf("%s", line.c_str()));
+    EXPECT_EQ(isUsbError(), CDC_ERROR_NONE);
+    EXPECT_EQ(24, USBnprintf("%s %d", line.c_str(), 12345));
+    EXPECT_EQ(isUsbError(), CDC_ERROR_CROPPED_TRANSMIT);
+
+    UsbTxCounters tx;
+    usbTxCounters(&tx);
+    EXPECT_EQ(1006 - 24, tx.dropped);
+    EXPECT_EQ(txAvailable(), 0);
+
+    uint32_t len = 10;
+    uint8_t buf[len];
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(txAvailable(), 1024);
+    ((USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData)->TxState = 0;
+    EXPECT_EQ(5, USBnprintf("clear"));
+    EXPECT_EQ(isUsbError(), CDC_ERROR_NONE);
+}
+
+static vector<bool> watermarkCalls;
+static void recordWatermark(bool high) {
+    watermarkCalls.push_back(high);
+}
+
+TEST_F(UsbPrintTest, test_flowControl) {
+    usb_cdc_fops.Init();
+    usbTxCountersReset();
+    watermarkCalls.clear();
+    usbTxFlowControl(true, 256, 768, recordWatermark);
+
+    uint32_t len = 10;
+    uint8_t buf[len];
+    char data[600];
+    memset(data, 'd', sizeof(data));
+    UsbTxCounters tx;
+
+    /* Idle, longer than the transfer buffer. All-or-nothing queues the rest instead of cutting */
+    char big[CIRCULAR_BUFFER_SIZE + 100] = {0};
+    EXPECT_EQ(CIRCULAR_BUFFER_SIZE + 100, writeUSB(big, sizeof(big)));
+    EXPECT_EQ(isUsbError(), CDC_ERROR_NONE);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(txAvailable(), 1024);
+
+    /* Busy, the high watermark is reported before data is lost */
+    ((USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData)->TxState = 1;
+    EXPECT_EQ(600, writeUSB(data, 600));
+    EXPECT_FALSE(usbTxThrottled());
+    EXPECT_EQ(200, USBnprintf("%.200s", data));
+    EXPECT_TRUE(usbTxThrottled());
+    EXPECT_THAT(watermarkCalls, ElementsAre(true));
+
+    /* Writes that do not fit are rejected as a whole */
+    EXPECT_EQ(0, writeUSB(data, 300));
+    EXPECT_EQ(isUsbError(), CDC_ERROR_TX_FULL);
+    EXPECT_EQ(0, USBnprintf("%.300s", data));
+    EXPECT_EQ(200, writeUSB(data, 200));
+    EXPECT_EQ(isUsbError(), CDC_ERROR_NONE);
+    EXPECT_EQ(txAvailable(), 24);
+
+    /* Low watermark reported from the main loop once the ring has drained */
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    usbTxPoll();
+    EXPECT_TRUE(usbTxThrottled());
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    usbTxPoll();
+    EXPECT_FALSE(usbTxThrottled());
+    EXPECT_THAT(watermarkCalls, ElementsAre(true, false));
+
+    usbTxCounters(&tx);
+    EXPECT_EQ(CIRCULAR_BUFFER_SIZE + 100 + 1000, tx.queued);
+    EXPECT_EQ(600, tx.dropped);
+    EXPECT_EQ(1000, tx.peakFill);
+    ((USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData)->TxState = 0;
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    usbTxFlowControl(false, 0, 0, NULL);
+}
+
+TEST_F(UsbPrintTest, test_allOrNothingPrint) {
+    usb_cdc_fops.Init();
+    usbTxCountersReset();
+    usbTxFlowControl(true, 0, 0, NULL);
+
+    uint32_t len = 10;
+    uint8_t buf[len];
+    char data[1000];
+    memset(data, 'd', sizeof(data));
+    UsbTxCounters tx;
+
+    /* Idle, formatted once into the transfer buffer and the ring */
+    EXPECT_EQ(1100, USBnprintf("%1100d", 7));
+    EXPECT_EQ(1024, hUsbDeviceFS.tx_count);
+    EXPECT_EQ(txAvailable(), 1024 - 76);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(76, hUsbDeviceFS.tx_count);
+    EXPECT_EQ('7', hUsbDeviceFS.tx_buf[75]);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(txAvailable(), 1024);
+
+    /* Busy, field widths are counted exactly and a rejected print leaves nothing in the ring */
+    ((USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData)->TxState = 1;
+    EXPECT_EQ(1000, writeUSB(data, 1000));
+    EXPECT_EQ(0, USBnprintf("%s%23d", "ab", 1));
+    EXPECT_EQ(isUsbError(), CDC_ERROR_TX_FULL);
+    EXPECT_EQ(txAvailable(), 24);
+    EXPECT_EQ(24, USBnprintf("%s%22d", "ab", 1));
+    EXPECT_EQ(isUsbError(), CDC_ERROR_NONE);
+    EXPECT_EQ(txAvailable(), 0);
+
+    usbTxCounters(&tx);
+    EXPECT_EQ(25, tx.dropped);
+    EXPECT_EQ(1100 + 1000 + 24, tx.queued);
+
+    /* The ring starts at 76, the print is at the end of the wrapped transfer */
+    ((USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData)->TxState = 0;
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(76, hUsbDeviceFS.tx_count);
+    EXPECT_EQ(0, memcmp(&hUsbDeviceFS.tx_buf[76 - 24], "ab                     1", 24));
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(txAvailable(), 1024);
+    usbTxFlowControl(false, 0, 0, NULL);
+}
+
+TEST_F(UsbPrintTest, test_transmitRetry) {
+    usb_cdc_fops.Init();
+    usbTxCountersReset();
+
+    /* A transfer that fails to start keeps its data and is retried */
+    ((USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData)->TxState = 1;
+    USBnprintf("retried\r\n");
+    ((USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData)->TxState = 0;
+    hUsbDeviceFS.ret_val = 3;
+
+    uint32_t len = 10;
+    uint8_t buf[len];
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(isUsbError(), CDC_ERROR_DELAYED_TRANSMIT);
+    EXPECT_EQ(txAvailable(), 1024 - 9);
+
+    hUsbDeviceFS.ret_val = 0;
+    usbTxPoll();
+    EXPECT_EQ(isUsbError(), CDC_ERROR_NONE);
+    EXPECT_EQ(9, hUsbDeviceFS.tx_count);
+    EXPECT_EQ(0, memcmp(hUsbDeviceFS.tx_buf, "retried\r\n", 9));
+
+    UsbTxCounters tx;
+    usbTxCounters(&tx);
+    EXPECT_EQ(1, tx.retries);
+    EXPECT_EQ(9, tx.sent);
+    usb_cdc_fops.TransmitCplt(buf, &len, 0);
+    EXPECT_EQ(txAvailable(), 1024);
+}
+
+TEST_F(UsbPrintTest, test_streamAdc) {
+    usb_cdc_fops.Init();
+
+    const int16_t adc[] = {10, 20, 30, 40, 50, 60};
+    BStreamHeader_t hdr = { BSTREAM_INT16, 2, 5, 12345, 0x6 };
+    ssize_t len = usbStreamAdc(&hdr, adc, 3, NULL);
+    ASSERT_GT(len, 0);
+    EXPECT_EQ(len, hUsbDeviceFS.tx_count);
+
+    /* The host decodes what was sent */
+    uint8_t frame[64];
+    memcpy(frame, hUsbDeviceFS.tx_buf, len);
+    EXPECT_EQ(frame[len - 1], 0);
+    BStreamHeader_t decoded;
+    float samples[4];
+    EXPECT_EQ(bstreamDecode(frame, len - 1, &decoded, samples, 4), 4);
+    EXPECT_EQ(decoded.sequence, 5);
+    EXPECT_THAT(samples, ElementsAre(20, 30, 50, 60));
+
+    /* Frames larger than the transmit buffer are refused */
+    static const int16_t large[2 * 300] = {0};
+    hdr = { BSTREAM_INT16, 300, 6, 0, 0x3 };
+    EXPECT_EQ(usbStreamAdc(&hdr, large, 2, NULL), -1);
+    usb_cdc_fops.TransmitCplt(frame, (uint32_t*) &len, 0);
+}
+
+TEST_F(UsbPrintTest, test_outStream) {
+    usb_cdc_fops.Init();
+
+    OutStream_t usb;
+    usbOutStreamInit(&usb);
+    EXPECT_EQ(outAvailable(&usb), 1024);
+    EXPECT_EQ(outPrintf(&usb, "%s, %d\r\n", "stream", 42), 12);
+    EXPECT_READ_USB(Contains("stream, 42\r"));
+    EXPECT_EQ(outFlush(&usb), 0);
 }
 
 TEST_F(UsbPrintTest, test_usb_connection) {
@@ -233,4 +233,161 @@ TEST_F(TestCAProtocolBoard, testPortCtrl)
     EXPECT_NE(testPortCtrl("p7 on 60e\r\n", 7, PortCfg()), 0);
     EXPECT_NE(testPortCtrl("p7 on 52 60\r\n", 7, PortCfg()), 0);
     EXPECT_NE(testPortCtrl("p7 sdfs 52 60%\r\n", 7, PortCfg()), 0);
-}
\ No newline at end of file
+}
+static std::queue<std::string> testLines;
+static int testLineReader(uint8_t* buf, size_t size)
+{
+    if (testLines.empty())
+        return 0;
+
+    int len = snprintf((char*) buf, size, "%s", testLines.front().c_str());
+    testLines.pop();
+    return len;
+}
+
+TEST(TestCAProtocolLines, testLineReader)
+{
+    CAProtocolCtx caProto = {};
+    caProto.calibration = CACalibrationCb;
+    initCAProtocolLines(&caProto, testLineReader);
+
+    // Nothing is called without a complete line
+    calData.noOfCalibration = -1;
+    inputCAProtocol(&caProto);
+    EXPECT_EQ(calData.noOfCalibration, -1);
+
+    testLines.push("CAL 3,0.05,1.56 2,344,36");
+    testLines.push("CAL 4,0.5,2");
+    inputCAProtocol(&caProto);
+    EXPECT_EQ(calCompare(2, (const CACalibration[]) {{3, 0.05, 1.56},{2, 344, 36}}), 0);
+    inputCAProtocol(&caProto);
+    EXPECT_EQ(calCompare(1, (const CACalibration[]) {{4, 0.5, 2}}), 0);
+    free(caProto.data);
+}
+
+static int streamFormatCalls;
+static bool streamBinary;
+static void testStreamFormat(bool binary)
+{
+    streamFormatCalls++;
+    streamBinary = binary;
+}
+
+TEST(TestCAProtocolLines, testStreamFormat)
+{
+    CAProtocolCtx caProto = {};
+    caProto.streamFormat = testStreamFormat;
+    caProto.undefined = [](const char* input) { strcpy(inputstr, input); };
+    initCAProtocolLines(&caProto, testLineReader);
+
+    testLines.push("STREAM bin");
+    inputCAProtocol(&caProto);
+    EXPECT_EQ(streamFormatCalls, 1);
+    EXPECT_TRUE(streamBinary);
+
+    testLines.push("STREAM csv");
+    inputCAProtocol(&caProto);
+    EXPECT_EQ(streamFormatCalls, 2);
+    EXPECT_FALSE(streamBinary);
+
+    memset(inputstr, '\0', sizeof(inputstr));
+    testLines.push("STREAM xml");
+    inputCAProtocol(&caProto);
+    EXPECT_EQ(streamFormatCalls, 2);
+    EXPECT_STREQ(inputstr, "STREAM xml");
+    free(caProto.data);
+}
+
+static std::string lastCommand;
+static int boardCommand(CAProtocolCtx* ctx, const char* input)
+{
+    lastCommand = input;
+    return 0;
+}
+
+TEST(TestCAProtocolRegistry, testDispatch)
+{
+    CAProtocolCtx caProto = {};
+    caProto.undefined = [](const char* input) { strcpy(inputstr, input); };
+    initCAProtocolLines(&caProto, testLineReader);
+
+    EXPECT_EQ(caRegisterCommand(&caProto, "p", boardCommand, 0), 0);
+    EXPECT_EQ(caRegisterCommand(&caProto, "all", boardCommand, CA_CMD_NEEDS_ARGS), 0);
+    EXPECT_EQ(caRegisterCommand(&caProto, "Serialx", boardCommand, 0), 0);
+
+    // The table stays sorted with the generic commands
+    CAProtocolData* data = caProto.data;
+    for (int i = 1; i < data->noOfCommands; i++)
+    {
+        EXPECT_LT(strcmp(data->commands[i-1].name, data->commands[i].name), 0);
+    }
+
+    testLines.push("p10 on");
+    inputCAProtocol(&caProto);
+    EXPECT_EQ(lastCommand, "p10 on");
+
+    testLines.push("all on");
+    inputCAProtocol(&caProto);
+    EXPECT_EQ(lastCommand, "all on");
+
+    testLines.push("Serialx");
+    inputCAProtocol(&caProto);
+    EXPECT_EQ(lastCommand, "Serialx");
+
+    // Missing arguments is a parse error, not passed to the handler
+    lastCommand.clear();
+    testLines.push("all");
+    inputCAProtocol(&caProto);
+    EXPECT_EQ(lastCommand, "");
+
+    // Names match whole, "pp" and "al" are not "p" and "all"
+    memset(inputstr, '\0', sizeof(inputstr));
+    testLines.push("pp 1");
+    inputCAProtocol(&caProto);
+    EXPECT_STREQ(inputstr, "pp 1");
+    testLines.push("al on");
+    inputCAProtocol(&caProto);
+    EXPECT_STREQ(inputstr, "al on");
+    EXPECT_EQ(lastCommand, "");
+    free(caProto.data);
+}
+
+TEST(TestCAProtocolRegistry, testRegister)
+{
+    CAProtocolCtx caProto = {};
+    initCAProtocolLines(&caProto, testLineReader);
+
+    // Duplicates and invalid names are rejected
+    EXPECT_EQ(caRegisterCommand(&caProto, "Serial", boardCommand, 0), -1);
+    EXPECT_EQ(caRegisterCommand(&caProto, "", boardCommand, 0), -1);
+    EXPECT_EQ(caRegisterCommand(&caProto, "p10", boardCommand, 0), -1);
+    EXPECT_EQ(caRegisterCommand(&caProto, "p", NULL, 0), -1);
+
+    // A generic command can be replaced
+    int noOfCommands = caProto.data->noOfCommands;
+    EXPECT_EQ(caRegisterCommand(&caProto, "Serial", boardCommand, CA_CMD_REPLACE), 0);
+    EXPECT_EQ(caProto.data->noOfCommands, noOfCommands);
+    testLines.push("Serial");
+    inputCAProtocol(&caProto);
+    EXPECT_EQ(lastCommand, "Serial");
+
+    // Fill the table
+    static char names[CA_MAX_COMMANDS][8];
+    int i = 0;
+    while (caProto.data->noOfCommands < CA_MAX_COMMANDS)
+    {
+        snprintf(names[i], sizeof(names[i]), "cmd%c", 'a' + i);
+        EXPECT_EQ(caRegisterCommand(&caProto, names[i], boardCommand, 0), 0);
+        i++;
+    }
+    EXPECT_EQ(caRegisterCommand(&caProto, "full", boardCommand, 0), -1);
+
+    // Every command is still found
+    for (int j = 0; j < i; j++)
+    {
+        testLines.push(names[j]);
+        inputCAProtocol(&caProto);
+        EXPECT_EQ(lastCommand, names[j]);
+    }
+    free(caProto.data);
+}
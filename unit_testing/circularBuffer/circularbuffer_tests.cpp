@@ -0,0 +1,169 @@
+/*!
+** @file   circularbuffer_tests.cpp
+** @date   15/10/2026
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cstring>
+
+/* UUT */
+#include "circular_buffer.h"
+
+using ::testing::ElementsAreArray;
+using namespace std;
+
+/***************************************************************************************************
+** TEST FIXTURES
+***************************************************************************************************/
+
+class CircularBufferTest: public ::testing::Test 
+{
+    protected:
+        /*******************************************************************************************
+        ** METHODS
+        *******************************************************************************************/
+        CircularBufferTest() {
+            cbuf = circular_buf_init_static(&cb, storage, sizeof(storage));
+        }
+
+        /*******************************************************************************************
+        ** MEMBERS
+        *******************************************************************************************/
+        circular_buf_t cb;
+        uint8_t storage[16];
+        cbuf_handle_t cbuf;
+};
+
+/***************************************************************************************************
+** TESTS
+***************************************************************************************************/
+
+TEST_F(CircularBufferTest, testWriteRead)
+{
+    uint8_t src[20];
+    uint8_t dst[20] = {0};
+    for (int i = 0; i < 20; i++) src[i] = i + 1;
+
+    EXPECT_EQ(circular_buf_write(cbuf, src, 10), 10u);
+    EXPECT_EQ(circular_buf_size(cbuf), 10u);
+    EXPECT_EQ(circular_buf_read(cbuf, dst, 4), 4u);
+    EXPECT_THAT(vector<uint8_t>(dst, dst + 4), ElementsAreArray(src, 4));
+
+    /* Wraps around the end of the storage, only the free space is written */
+    EXPECT_EQ(circular_buf_write(cbuf, &src[10], 12), 10u);
+    EXPECT_EQ(circular_buf_size(cbuf), 16u);
+    EXPECT_TRUE(circular_buf_full(cbuf));
+    EXPECT_EQ(circular_buf_write(cbuf, src, 1), 0u);
+
+    /* Wrapped read, mixed with single byte access */
+    uint8_t byte;
+    EXPECT_EQ(circular_buf_get(cbuf, &byte), 0);
+    EXPECT_EQ(byte, 5);
+    EXPECT_EQ(circular_buf_read(cbuf, dst, 20), 15u);
+    EXPECT_THAT(vector<uint8_t>(dst, dst + 15), ElementsAreArray(&src[5], 15));
+    EXPECT_TRUE(circular_buf_empty(cbuf));
+    EXPECT_EQ(circular_buf_read(cbuf, dst, 1), 0u);
+}
+
+TEST_F(CircularBufferTest, testMatchesBytewise)
+{
+    /* Random sized bulk transfers give the same stream as single bytes */
+    circular_buf_t refCb;
+    uint8_t refStorage[16];
+    cbuf_handle_t ref = circular_buf_init_static(&refCb, refStorage, sizeof(refStorage));
+
+    uint8_t next = 0;
+    srand(1);
+    for (int i = 0; i < 1000; i++)
+    {
+        uint8_t buf[20], refBuf[20];
+        size_t len = rand() % 20;
+        for (size_t j = 0; j < len; j++) buf[j] = next + j;
+
+        size_t refLen = 0;
+        while (refLen < len && circular_buf_put(ref, buf[refLen]) == 0) refLen++;
+        size_t written = circular_buf_write(cbuf, buf, len);
+        ASSERT_EQ(written, refLen);
+        next += written;
+
+        len = rand() % 20;
+        refLen = 0;
+        while (refLen < len && circular_buf_get(ref, &refBuf[refLen]) == 0) refLen++;
+        ASSERT_EQ(circular_buf_read(cbuf, buf, len), refLen);
+        ASSERT_EQ(memcmp(buf, refBuf, refLen), 0);
+        ASSERT_EQ(circular_buf_size(cbuf), circular_buf_size(ref));
+        ASSERT_EQ(circular_buf_full(cbuf), circular_buf_full(ref));
+    }
+}
+
+TEST_F(CircularBufferTest, testPeekCommit)
+{
+    const uint8_t *data;
+    uint8_t *space;
+
+    EXPECT_EQ(circular_buf_peek_contiguous(cbuf, &data), 0u);
+    EXPECT_EQ(circular_buf_reserve(cbuf, &space), 16u);
+    EXPECT_EQ(space, storage);
+
+    /* Writer fills part of the reserved region in place */
+    memcpy(space, "abcdefghijkl", 12);
+    circular_buf_commit_write(cbuf, 12);
+    EXPECT_EQ(circular_buf_size(cbuf), 12u);
+
+    /* Reader consumes in place, in two steps */
+    EXPECT_EQ(circular_buf_peek_contiguous(cbuf, &data), 12u);
+    EXPECT_EQ(data, storage);
+    circular_buf_commit_read(cbuf, 5);
+    EXPECT_EQ(circular_buf_peek_contiguous(cbuf, &data), 7u);
+    EXPECT_EQ(memcmp(data, "fghijkl", 7), 0);
+
+    /* Free space wraps, the contiguous region ends at the end of the storage */
+    EXPECT_EQ(circular_buf_reserve(cbuf, &space), 4u);
+    EXPECT_EQ(space, &storage[12]);
+    memcpy(space, "mnop", 4);
+    circular_buf_commit_write(cbuf, 4);
+    EXPECT_EQ(circular_buf_reserve(cbuf, &space), 5u);
+    EXPECT_EQ(space, storage);
+    memcpy(space, "qrstu", 5);
+    circular_buf_commit_write(cbuf, 5);
+    EXPECT_TRUE(circular_buf_full(cbuf));
+    EXPECT_EQ(circular_buf_reserve(cbuf, &space), 0u);
+
+    /* Readable data wraps as well */
+    EXPECT_EQ(circular_buf_peek_contiguous(cbuf, &data), 11u);
+    EXPECT_EQ(memcmp(data, "fghijklmnop", 11), 0);
+    circular_buf_commit_read(cbuf, 11);
+    EXPECT_FALSE(circular_buf_full(cbuf));
+    EXPECT_EQ(circular_buf_peek_contiguous(cbuf, &data), 5u);
+    EXPECT_EQ(memcmp(data, "qrstu", 5), 0);
+    circular_buf_commit_read(cbuf, 5);
+    EXPECT_TRUE(circular_buf_empty(cbuf));
+}
+
+TEST_F(CircularBufferTest, testStageCommit)
+{
+    uint8_t out[16];
+
+    /* Move head and tail near the end so the staged bytes wrap */
+    EXPECT_EQ(circular_buf_write(cbuf, (const uint8_t *) "0123456789", 10), 10u);
+    EXPECT_EQ(circular_buf_read(cbuf, out, 8), 8u);
+
+    /* Staged pieces are not visible until committed */
+    EXPECT_EQ(circular_buf_stage(cbuf, 0, (const uint8_t *) "abcd", 4), 4u);
+    EXPECT_EQ(circular_buf_stage(cbuf, 4, (const uint8_t *) "efgh", 4), 4u);
+    EXPECT_EQ(circular_buf_size(cbuf), 2u);
+
+    /* Cut where the free space ends, nothing beyond it */
+    EXPECT_EQ(circular_buf_stage(cbuf, 8, (const uint8_t *) "ijklmnop", 8), 6u);
+    EXPECT_EQ(circular_buf_stage(cbuf, 14, (const uint8_t *) "q", 1), 0u);
+
+    circular_buf_commit_write(cbuf, 14);
+    EXPECT_TRUE(circular_buf_full(cbuf));
+    EXPECT_EQ(circular_buf_read(cbuf, out, 16), 16u);
+    EXPECT_EQ(memcmp(out, "89abcdefghijklmn", 16), 0);
+
+    /* Not committing drops the staged bytes */
+    EXPECT_EQ(circular_buf_stage(cbuf, 0, (const uint8_t *) "xyz", 3), 3u);
+    EXPECT_TRUE(circular_buf_empty(cbuf));
+}
@@ -0,0 +1,119 @@
+/*!
+** @file   ringbuffer_tests.cpp
+** @date   15/10/2026
+*/
+
+#include <gtest/gtest.h>
+
+/* UUT */
+#include "ring_buffer.h"
+
+RING_BUF_STATIC(samples, int16_t, 8, RING_BUF_REJECT_NEW);
+RING_BUF_TYPED(sample_ring, int16_t)
+
+typedef struct {
+    uint32_t timestamp;
+    double value;
+    uint8_t flags;
+} record_t;
+
+RING_BUF_TYPED(record_ring, record_t)
+
+TEST(RingBuffer, testInit)
+{
+    ring_buf_t ring;
+    double storage[4];
+
+    EXPECT_EQ(-1, ring_buf_init(&ring, storage, 0, 4, RING_BUF_REJECT_NEW));
+    EXPECT_EQ(-1, ring_buf_init(&ring, storage, sizeof(double), 0, RING_BUF_REJECT_NEW));
+    EXPECT_EQ(-1, ring_buf_init(&ring, NULL, sizeof(double), 4, RING_BUF_REJECT_NEW));
+    EXPECT_EQ(0, ring_buf_init(&ring, storage, sizeof(double), 4, RING_BUF_REJECT_NEW));
+    EXPECT_EQ(0, ring_buf_count(&ring));
+    EXPECT_EQ(4, ring_buf_capacity(&ring));
+}
+
+TEST(RingBuffer, testStaticRejectNew)
+{
+    int16_t in[10] = { -1, 2, -3, 4, -5, 6, -7, 8, -9, 10 };
+    int16_t out[10] = { 0 };
+
+    ring_buf_reset(&samples);
+    EXPECT_EQ(8, ring_buf_capacity(&samples));
+
+    // Bulk push wrapping around the end of the storage
+    EXPECT_EQ(5, sample_ring_push(&samples, in, 5));
+    EXPECT_EQ(2, sample_ring_pop(&samples, out, 2));
+    EXPECT_EQ(5, sample_ring_push(&samples, &in[5], 5));
+    EXPECT_EQ(8, ring_buf_count(&samples));
+
+    // Full ring rejects new samples and counts them
+    EXPECT_EQ(0, sample_ring_push(&samples, in, 3));
+    EXPECT_EQ(3, samples.dropped);
+
+    int16_t first;
+    EXPECT_EQ(0, sample_ring_peek(&samples, 0, &first));
+    EXPECT_EQ(-3, first);
+    EXPECT_EQ(-1, sample_ring_peek(&samples, 8, &first));
+
+    EXPECT_EQ(8, sample_ring_pop(&samples, out, 10));
+    int16_t expected[8] = { -3, 4, -5, 6, -7, 8, -9, 10 };
+    for (int i = 0; i < 8; i++)
+    {
+        EXPECT_EQ(expected[i], out[i]);
+    }
+    EXPECT_EQ(0, ring_buf_count(&samples));
+    EXPECT_EQ(0, sample_ring_pop(&samples, out, 1));
+}
+
+TEST(RingBuffer, testOverwriteOldest)
+{
+    ring_buf_t ring;
+    double storage[4];
+    double in[6] = { 0.5, 1.5, 2.5, 3.5, 4.5, 5.5 };
+    double out[4];
+
+    ring_buf_init(&ring, storage, sizeof(double), 4, RING_BUF_OVERWRITE_OLDEST);
+
+    EXPECT_EQ(3, ring_buf_push(&ring, in, 3));
+    EXPECT_EQ(2, ring_buf_push(&ring, &in[3], 2));
+    EXPECT_EQ(4, ring_buf_count(&ring));
+    EXPECT_EQ(1, ring.dropped);
+
+    EXPECT_EQ(4, ring_buf_pop(&ring, out, 4));
+    EXPECT_DOUBLE_EQ(1.5, out[0]);
+    EXPECT_DOUBLE_EQ(4.5, out[3]);
+
+    // Pushing more than the capacity keeps the newest elements
+    ring_buf_push(&ring, in, 1);
+    EXPECT_EQ(6, ring_buf_push(&ring, in, 6));
+    EXPECT_EQ(4, ring_buf_count(&ring));
+    EXPECT_EQ(4, ring_buf_pop(&ring, out, 4));
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_DOUBLE_EQ(in[i + 2], out[i]);
+    }
+}
+
+TEST(RingBuffer, testStructs)
+{
+    ring_buf_t ring;
+    record_t storage[3];
+    record_t rec;
+
+    ring_buf_init(&ring, storage, sizeof(record_t), 3, RING_BUF_OVERWRITE_OLDEST);
+
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        rec = { i, i * 0.25, (uint8_t) (i & 1) };
+        EXPECT_EQ(1, record_ring_push(&ring, &rec, 1));
+    }
+
+    EXPECT_EQ(3, ring_buf_count(&ring));
+    for (uint32_t i = 7; i < 10; i++)
+    {
+        EXPECT_EQ(1, record_ring_pop(&ring, &rec, 1));
+        EXPECT_EQ(i, rec.timestamp);
+        EXPECT_DOUBLE_EQ(i * 0.25, rec.value);
+        EXPECT_EQ(i & 1, rec.flags);
+    }
+}
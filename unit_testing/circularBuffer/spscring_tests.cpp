@@ -0,0 +1,172 @@
+/*!
+** @file   spscring_tests.cpp
+** @date   15/10/2026
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+
+/* UUT */
+#include "spsc_ring.h"
+
+using ::testing::ElementsAreArray;
+using namespace std;
+
+/***************************************************************************************************
+** TEST FIXTURES
+***************************************************************************************************/
+
+class SpscRingTest: public ::testing::Test 
+{
+    protected:
+        /*******************************************************************************************
+        ** METHODS
+        *******************************************************************************************/
+        SpscRingTest() {
+            spsc_ring_init(&ring, storage, sizeof(storage));
+        }
+
+        /*******************************************************************************************
+        ** MEMBERS
+        *******************************************************************************************/
+        spsc_ring_t ring;
+        uint8_t storage[16];
+};
+
+/* Shared by the stress test threads */
+static const size_t STRESS_BYTES = 10000000;
+
+static void* producer(void* arg)
+{
+    spsc_ring_t* ring = (spsc_ring_t*) arg;
+    uint8_t chunk[37];
+    size_t sent = 0;
+    unsigned int seed = 1;
+
+    while (sent < STRESS_BYTES)
+    {
+        size_t len = 1 + rand_r(&seed) % sizeof(chunk);
+        if (len > STRESS_BYTES - sent) len = STRESS_BYTES - sent;
+        for (size_t i = 0; i < len; i++) chunk[i] = (uint8_t) ((sent + i) * 7);
+
+        size_t written = (len == 1) ? (spsc_ring_put(ring, chunk[0]) == 0) : spsc_ring_write(ring, chunk, len);
+        sent += written;
+        if (written == 0)
+            sched_yield(); // Ring full, let the consumer run (single core hosts)
+    }
+    return NULL;
+}
+
+/***************************************************************************************************
+** TESTS
+***************************************************************************************************/
+
+TEST_F(SpscRingTest, testInit)
+{
+    uint8_t buf[12];
+    spsc_ring_t other;
+    EXPECT_EQ(spsc_ring_init(&other, buf, sizeof(buf)), -1);
+    EXPECT_EQ(spsc_ring_init(&other, buf, 0), -1);
+    EXPECT_EQ(spsc_ring_init(&other, buf, 8), 0);
+    EXPECT_EQ(spsc_ring_capacity(&ring), 16u);
+    EXPECT_EQ(spsc_ring_size(&ring), 0u);
+    EXPECT_EQ(spsc_ring_space(&ring), 16u);
+}
+
+TEST_F(SpscRingTest, testWriteRead)
+{
+    uint8_t src[20];
+    uint8_t dst[20] = {0};
+    for (int i = 0; i < 20; i++) src[i] = i + 1;
+
+    /* The whole capacity is usable */
+    EXPECT_EQ(spsc_ring_write(&ring, src, 20), 16u);
+    EXPECT_EQ(spsc_ring_put(&ring, 0), -1);
+    EXPECT_EQ(spsc_ring_space(&ring), 0u);
+    EXPECT_EQ(spsc_ring_read(&ring, dst, 10), 10u);
+    EXPECT_THAT(vector<uint8_t>(dst, dst + 10), ElementsAreArray(src, 10));
+
+    /* Wrapped write and read */
+    EXPECT_EQ(spsc_ring_write(&ring, &src[16], 4), 4u);
+    uint8_t byte;
+    EXPECT_EQ(spsc_ring_get(&ring, &byte), 0);
+    EXPECT_EQ(byte, 11);
+    EXPECT_EQ(spsc_ring_read(&ring, dst, 20), 9u);
+    EXPECT_THAT(vector<uint8_t>(dst, dst + 9), ElementsAreArray(&src[11], 9));
+    EXPECT_EQ(spsc_ring_get(&ring, &byte), -1);
+
+    /* Flush from the consumer side */
+    spsc_ring_write(&ring, src, 5);
+    spsc_ring_flush(&ring);
+    EXPECT_EQ(spsc_ring_size(&ring), 0u);
+    EXPECT_EQ(spsc_ring_space(&ring), 16u);
+}
+
+TEST_F(SpscRingTest, testPeekSkip)
+{
+    uint8_t src[16];
+    uint8_t dst[16] = {0};
+    for (int i = 0; i < 16; i++) src[i] = i + 1;
+
+    /* Peek leaves the bytes in the ring, also when wrapped */
+    ring.head = ring.tail = 12;
+    EXPECT_EQ(spsc_ring_write(&ring, src, 8), 8u);
+    EXPECT_EQ(spsc_ring_peek(&ring, dst, 16), 8u);
+    EXPECT_THAT(vector<uint8_t>(dst, dst + 8), ElementsAreArray(src, 8));
+    EXPECT_EQ(spsc_ring_size(&ring), 8u);
+
+    /* Skip is bounded by the content */
+    spsc_ring_skip(&ring, 3);
+    EXPECT_EQ(spsc_ring_peek(&ring, dst, 2), 2u);
+    EXPECT_THAT(vector<uint8_t>(dst, dst + 2), ElementsAreArray(&src[3], 2));
+    spsc_ring_skip(&ring, 100);
+    EXPECT_EQ(spsc_ring_size(&ring), 0u);
+    EXPECT_EQ(spsc_ring_space(&ring), 16u);
+}
+
+TEST_F(SpscRingTest, testIndexOverflow)
+{
+    /* Free running indexes wrap around SIZE_MAX */
+    ring.head = ring.tail = SIZE_MAX - 5;
+    uint8_t src[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    uint8_t dst[10];
+    EXPECT_EQ(spsc_ring_write(&ring, src, 10), 10u);
+    EXPECT_EQ(spsc_ring_size(&ring), 10u);
+    EXPECT_EQ(spsc_ring_read(&ring, dst, 10), 10u);
+    EXPECT_THAT(dst, ElementsAreArray(src));
+}
+
+TEST_F(SpscRingTest, testStressTwoThreads)
+{
+    uint8_t stressStorage[64];
+    ASSERT_EQ(spsc_ring_init(&ring, stressStorage, sizeof(stressStorage)), 0);
+
+    pthread_t thread;
+    ASSERT_EQ(pthread_create(&thread, NULL, producer, &ring), 0);
+
+    uint8_t chunk[29];
+    size_t received = 0;
+    size_t errors = 0;
+    unsigned int seed = 2;
+    while (received < STRESS_BYTES)
+    {
+        size_t len = 1 + rand_r(&seed) % sizeof(chunk);
+        size_t read = (len == 1) ? (spsc_ring_get(&ring, chunk) == 0) : spsc_ring_read(&ring, chunk, len);
+        for (size_t i = 0; i < read; i++)
+        {
+            if (chunk[i] != (uint8_t) ((received + i) * 7))
+                errors++;
+        }
+        received += read;
+        if (read == 0)
+            sched_yield();
+    }
+
+    pthread_join(thread, NULL);
+    EXPECT_EQ(errors, 0u);
+    EXPECT_EQ(received, STRESS_BYTES);
+    EXPECT_EQ(spsc_ring_size(&ring), 0u);
+}
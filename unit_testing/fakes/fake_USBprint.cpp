@@ -6,6 +6,7 @@
 
 #include <fstream>
 #include <cstdio>
+#include <cstring>
 #include <cstdarg>
 #include <vector>
 #include <sstream>
@@ -70,15 +71,18 @@ int USBnprintf(const char * format, ... )
 {
     va_list argptr;
     va_start(argptr, format);
+    int len = USBvprintf(format, argptr);
+    va_end(argptr);
+    return len;
+}
 
+int USBvprintf(const char * format, va_list argptr)
+{
     char buf[TX_RX_BUFFER_LENGTH] = {0};
     size_t len = 0;
     len += vsnprintf(&buf[len], TX_RX_BUFFER_LENGTH - 2, format, argptr);
 
-    len = writeUSB(buf, len);
-
-    va_end(argptr);
-    return len;
+    return writeUSB(buf, len);
 }
 
 ssize_t writeUSB(const void *buf, size_t count)
@@ -98,6 +102,34 @@ ssize_t writeUSB(const void *buf, size_t count)
     return count;
 }
 
+void usbCsvWrite(void *ctx, const char *data, size_t len)
+{
+    writeUSB(data, len);
+}
+
+static ssize_t fakeStreamWrite(void *ctx, const uint8_t *buf, size_t len)
+{
+    return writeUSB(buf, len);
+}
+
+static size_t fakeStreamAvailable(void *ctx)
+{
+    return txAvailable();
+}
+
+void usbOutStreamInit(OutStream_t *stream)
+{
+    stream->write = fakeStreamWrite;
+    stream->available = fakeStreamAvailable;
+    stream->flush = NULL;
+    stream->ctx = NULL;
+}
+
+ssize_t usbStreamAdc(const BStreamHeader_t *hdr, const int16_t *pBuffer, int noOfChannels, const float *scale)
+{
+    return 0;
+}
+
 size_t txAvailable()
 {
     return rx_len;
@@ -127,6 +159,40 @@ int usbRx(uint8_t* buf)
     }
 }
 
+/*!
+** @brief Function to get the next complete line from the USB receive buffer
+*/
+int usbRxLine(uint8_t* buf, size_t size)
+{
+    while (rx_len != 0 && (RX_buffer[rx_off] == '\r' || RX_buffer[rx_off] == '\n')) {
+        rx_off++;
+        rx_len--;
+    }
+
+    size_t len = 0;
+    while (len < rx_len && RX_buffer[rx_off + len] != '\r' && RX_buffer[rx_off + len] != '\n')
+        len++;
+    if (len == rx_len || size == 0)
+        return 0; // No complete line
+
+    size_t copy = (len < size - 1) ? len : size - 1;
+    memcpy(buf, &RX_buffer[rx_off], copy);
+    buf[copy] = '\0';
+    rx_off += len + 1;
+    rx_len -= len + 1;
+    return copy;
+}
+
+/*!
+** @brief Writes are passed on at once, nothing to coalesce
+*/
+void usbTxCoalesce(uint32_t timeoutUs) {}
+int usbTxFlush() { return 0; }
+void usbTxPoll() {}
+void usbTxFlowControl(bool allOrNothing, size_t lowWatermark, size_t highWatermark, void (*watermark)(bool high)) {}
+bool usbTxThrottled() { return false; }
+void usbTxCounters(UsbTxCounters *counters) { *counters = UsbTxCounters(); }
+
 /*!
 ** @brief Returns if there has been an error in the USB stack
 */
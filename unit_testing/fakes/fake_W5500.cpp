@@ -43,3 +43,10 @@ int W5500Init(ethernet_t *heth, SPI_HandleTypeDef *hspi, GPIO_TypeDef *port, uin
 int W5500TCPServer(ethernet_t *heth) {
     return 0;
 }
+
+void W5500OutStreamInit(ethernet_t *heth, OutStream_t *stream) {
+    stream->write     = NULL;
+    stream->available = NULL;
+    stream->flush     = NULL;
+    stream->ctx       = heth;
+}
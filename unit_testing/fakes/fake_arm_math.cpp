@@ -0,0 +1,56 @@
+/*!
+** @file   fake_arm_math.cpp
+** @date   16/10/2026
+*/
+
+#include <cmath>
+#include <cstdlib>
+
+#include "fake_arm_math.h"
+
+arm_status arm_rfft_init_q15(arm_rfft_instance_q15* S, uint32_t fftLenReal, uint32_t ifftFlagR, uint32_t bitReverseFlag)
+{
+    if (fftLenReal < 32 || fftLenReal > 8192 || (fftLenReal & (fftLenReal - 1)) != 0)
+        return ARM_MATH_ARGUMENT_ERROR;
+
+    S->fftLenReal = fftLenReal;
+    S->ifftFlagR = ifftFlagR;
+    S->bitReverseFlagR = bitReverseFlag;
+    return ARM_MATH_SUCCESS;
+}
+
+void arm_rfft_q15(const arm_rfft_instance_q15* S, q15_t* pSrc, q15_t* pDst)
+{
+    const uint32_t n = S->fftLenReal;
+    for (uint32_t k = 0; k < n; k++)
+    {
+        double re = 0;
+        double im = 0;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            re += pSrc[i] * cos(2 * M_PI * k * i / n);
+            im -= pSrc[i] * sin(2 * M_PI * k * i / n);
+        }
+        pDst[2*k]   = (q15_t) lround(sqrt(re*re + im*im) / n);
+        pDst[2*k+1] = 0;
+    }
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        pSrc[i] = (q15_t) 0x5A5A;
+    }
+}
+
+void arm_absmax_q15(const q15_t* pSrc, uint32_t blockSize, q15_t* pResult, uint32_t* pIndex)
+{
+    *pResult = 0;
+    *pIndex = 0;
+    for (uint32_t i = 0; i < blockSize; i++)
+    {
+        if (abs(pSrc[i]) > abs(*pResult))
+        {
+            *pResult = pSrc[i];
+            *pIndex = i;
+        }
+    }
+}
@@ -0,0 +1,41 @@
+/*!
+** @file   fake_arm_math.h
+** @brief  Host stand-in for the CMSIS-DSP functions used by CaCMSISInterface
+** @date   16/10/2026
+*/
+
+/* Define to prevent inclusion of real module */
+#ifndef _ARM_MATH_H
+#define _ARM_MATH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int16_t q15_t;
+
+typedef enum {
+    ARM_MATH_SUCCESS = 0,
+    ARM_MATH_ARGUMENT_ERROR = -1
+} arm_status;
+
+typedef struct {
+    uint32_t fftLenReal;
+    uint8_t ifftFlagR;
+    uint8_t bitReverseFlagR;
+} arm_rfft_instance_q15;
+
+arm_status arm_rfft_init_q15(arm_rfft_instance_q15* S, uint32_t fftLenReal, uint32_t ifftFlagR, uint32_t bitReverseFlag);
+// Magnitude spectrum scaled by 1/fftLen in the real parts of pDst. Like the real function pSrc is
+// used as work area, it is overwritten.
+void arm_rfft_q15(const arm_rfft_instance_q15* S, q15_t* pSrc, q15_t* pDst);
+void arm_absmax_q15(const q15_t* pSrc, uint32_t blockSize, q15_t* pResult, uint32_t* pIndex);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ARM_MATH_H */
@@ -175,6 +175,31 @@ extern SCB_Type SCB_obj;
 
 #define SCB ((SCB_Type *) &SCB_obj)
 
+typedef struct
+{
+  __IOM uint32_t CTRL;                   /*!< Offset: 0x000 (R/W)  Control Register */
+  __IOM uint32_t CYCCNT;                 /*!< Offset: 0x004 (R/W)  Cycle Count Register */
+} DWT_Type;
+
+extern DWT_Type DWT_obj;
+
+#define DWT ((DWT_Type *) &DWT_obj)
+#define DWT_CTRL_CYCCNTENA_Msk             (0x1UL /*<< DWT_CTRL_CYCCNTENA_Pos*/)
+
+typedef struct
+{
+  __IOM uint32_t DHCSR;                  /*!< Offset: 0x000 (R/W)  Debug Halting Control and Status Register */
+  __OM  uint32_t DCRSR;                  /*!< Offset: 0x004 ( /W)  Debug Core Register Selector Register */
+  __IOM uint32_t DCRDR;                  /*!< Offset: 0x008 (R/W)  Debug Core Register Data Register */
+  __IOM uint32_t DEMCR;                  /*!< Offset: 0x00C (R/W)  Debug Exception and Monitor Control Register */
+} CoreDebug_Type;
+
+extern CoreDebug_Type CoreDebug_obj;
+
+#define CoreDebug ((CoreDebug_Type *) &CoreDebug_obj)
+#define CoreDebug_DEMCR_TRCENA_Pos         24U
+#define CoreDebug_DEMCR_TRCENA_Msk         (1UL << CoreDebug_DEMCR_TRCENA_Pos)
+
 // End of #include "core_cm4.h"
 
 extern uint32_t SystemCoreClock;          /*!< System Clock Frequency (Core Clock) */
@@ -67,6 +67,9 @@ DMA_Stream_TypeDef DMA2_Stream7_obj;
 DBGMCU_TypeDef DBGMCU_obj;
 USB_OTG_GlobalTypeDef USB_OTG_FS_obj;
 SCB_Type SCB_obj;
+DWT_Type DWT_obj;
+CoreDebug_Type CoreDebug_obj;
+uint32_t SystemCoreClock = 16000000;
 
 /***************************************************************************************************
 ** PRIVATE MEMBERS
@@ -79,6 +82,9 @@ static uint32_t next_tick = 0;
 /* For simulating I2C devices */
 std::vector<stm32I2cTestDevice*>* devices = nullptr;
 
+/* For simulating UART devices */
+std::vector<stm32UartTestDevice*>* uartDevices = nullptr;
+
 /***************************************************************************************************
 ** PUBLIC FUNCTIONS
 ***************************************************************************************************/
@@ -93,6 +99,12 @@ HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, ui
     return HAL_OK;
 }
 
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef* hadc, uint32_t CalibrationMode, uint32_t SingleDiff)
+{
+    /* Do nothing */
+    return HAL_OK;
+}
+
 __weak void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc)
 {
   /* Prevent unused argument(s) compilation warning */
@@ -260,6 +272,31 @@ HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAd
 
 #endif
 
+#ifdef HAL_UART_MODULE_ENABLED
+
+void fakeHAL_UART_addDevice(stm32UartTestDevice* new_device) {
+    if(!uartDevices) {
+        uartDevices = new std::vector<stm32UartTestDevice*>();
+    }
+
+    uartDevices->push_back(new_device);
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    if(uartDevices) {
+        for(const auto& i : *uartDevices) {
+            if(i->bus == huart->Instance) {
+                return i->transmit(pData, Size, Timeout);
+            }
+        }
+    }
+
+    return HAL_ERROR;
+}
+
+#endif
+
 #ifdef HAL_FLASH_MODULE_ENABLED
 HAL_StatusTypeDef HAL_FLASH_Lock(void)
 {
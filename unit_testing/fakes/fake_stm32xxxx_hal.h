@@ -58,6 +58,8 @@ typedef struct ADC_HandleTypeDef
     /* For imitating DMA samples */
     uint32_t* dma_address;
     uint32_t  dma_length;
+
+    ADC_TypeDef* Instance;
 } ADC_HandleTypeDef;
 
 /* For simulating I2C devices */
@@ -69,6 +71,13 @@ class stm32I2cTestDevice {
         virtual HAL_StatusTypeDef recv(uint8_t* buf, uint8_t size) = 0;
 };
 
+/* For simulating UART devices */
+class stm32UartTestDevice {
+    public:
+        USART_TypeDef*  bus;
+        virtual HAL_StatusTypeDef transmit(const uint8_t* buf, uint16_t size, uint32_t timeout) = 0;
+};
+
 /***************************************************************************************************
 ** PUBLIC OBJECTS
 ***************************************************************************************************/
@@ -81,6 +90,7 @@ class stm32I2cTestDevice {
 HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length);
 void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc);
 void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef* hadc, uint32_t CalibrationMode, uint32_t SingleDiff);
 
 /* HAL */
 void forceTick(uint32_t next_val);
@@ -89,6 +99,7 @@ uint32_t HAL_GetTick(void);
 void HAL_Delay(uint32_t Delay);
 
 void fakeHAL_I2C_addDevice(stm32I2cTestDevice* new_device);
+void fakeHAL_UART_addDevice(stm32UartTestDevice* new_device);
 
 #ifdef __cplusplus
 }
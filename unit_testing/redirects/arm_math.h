@@ -0,0 +1 @@
+#include "fake_arm_math.h"
\ No newline at end of file